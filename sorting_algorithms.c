@@ -1,35 +1,138 @@
 
 
+#include "sortlib.h"
+#include "sortlib_private.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
-#include <sys/time.h>
 #include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
 
 // ============================================================================
 // CONSTANTS AND CONFIGURATION
 // ============================================================================
 
-#define MAX_STRING_LENGTH 100
 #define MAX_DISPLAY_SIZE 50  // Limit display for large arrays
 #define SEPARATOR_LENGTH 60
+#define RESULTS_FILE "benchmark_results.csv"
+#define TRACE_RING_CAPACITY (1 << 16)  // Events buffered between sorter and writer
+#define TRACE_MAGIC "STRC"
+#define TRACE_VERSION 1
+#define MAX_FIELD_LENGTH 128
+#define MAX_RUNS_LISTED 50
+#define VERIFY_QUADRATIC_LIMIT 20000   // Verification skips quadratic engines above this size
+#define VERIFY_STABILITY_LIMIT 10000000  // Largest input of the stability checks
+#define VERIFY_STRING_LIMIT 1000000    // Largest input of the string and list checks
+#define VERIFY_STRING_WIDTH 8          // Bytes per generated string, NUL included
+#define VERIFY_BATCH_CAPACITY 16       // Container batch size: many flushes and merges
+
+// Recorded with every benchmark result; pass -DBUILD_FLAGS / -DGIT_REVISION
+// at compile time to fill them in
+#ifndef BUILD_FLAGS
+#define BUILD_FLAGS "unknown"
+#endif
+#ifndef GIT_REVISION
+#define GIT_REVISION "unknown"
+#endif
 
 // ============================================================================
 // DATA STRUCTURES
 // ============================================================================
 
+// Environment shared by every record of one benchmark run
+typedef struct {
+    char runId[MAX_FIELD_LENGTH];
+    char cpuModel[MAX_FIELD_LENGTH];
+    char compiler[MAX_FIELD_LENGTH];
+    char buildFlags[MAX_FIELD_LENGTH];
+    char gitRevision[MAX_FIELD_LENGTH];
+} BenchmarkRun;
+
+// One line of RESULTS_FILE
+typedef struct {
+    char runId[MAX_FIELD_LENGTH];
+    char algorithm[MAX_FIELD_LENGTH];
+    char distribution[MAX_FIELD_LENGTH];
+    char order[MAX_FIELD_LENGTH];
+    size_t size;
+    unsigned int threads;
+    double timeMs;
+    unsigned long long comparisons;
+    unsigned long long swaps;
+} BenchmarkRecord;
+
+// 16 bytes per event: the op lives in the top 8 bits of the first word
+typedef struct {
+    uint64_t opAndFirst;
+    uint64_t second;
+} TraceEvent;
+
+// Single-producer ring buffer drained to a file by a background thread
 typedef struct {
-    unsigned long long comparisons;  // Prevent overflow for large datasets
-    unsigned long long swaps;        // Prevent overflow for large datasets
-    double execution_time_ms;        // Time in milliseconds
-} SortStats;
+    TraceEvent* events;
+    atomic_size_t head;              // Next slot the sorter writes
+    atomic_size_t tail;              // Next slot the writer drains
+    atomic_bool done;
+    FILE* file;
+    pthread_t writer;
+    unsigned long long recorded;
+    bool failed;                     // A write came up short; set by the writer thread
+    sortlib_Observer observer;       // Passed to the traced sort
+} StepTracer;
 
-typedef struct Node {
-    char info[MAX_STRING_LENGTH];
-    struct Node* next;
-} Node;
+// Order-independent fingerprint of an array's values
+typedef struct {
+    uint64_t sum;
+    uint64_t sumAlternate;
+} MultisetHash;
+
+typedef struct {
+    const char* name;
+    void (*generate)(int* arr, size_t size, uint64_t* seed);
+} VerifyDistribution;
+
+typedef enum {
+    VERIFY_LINEARITHMIC,
+    VERIFY_QUADRATIC
+} VerifyCost;
+
+typedef struct {
+    const char* name;
+    sortlib_ArraySortFunction sort;
+    VerifyCost cost;
+    bool usesPool;                   // Runs on verifyPool's threads
+} VerifyEngine;
+
+// One (distribution, size) case of a verification run
+typedef struct {
+    const char* distribution;
+    const int* values;               // The input; checks sort copies of it
+    size_t size;
+    bool ascending;
+    bool report;                     // Print every check, not only failures
+    MultisetHash inputHash;
+    const char* reference;           // First int engine whose output passed
+    uint64_t referenceHash;          // sequenceHash of that output
+    unsigned int passed;
+    unsigned int failed;
+    unsigned int skipped;
+} VerifyCase;
 
 // ============================================================================
 // UTILITY FUNCTIONS
@@ -43,12 +146,6 @@ void clearScreen() {
     #endif
 }
 
-double getTimeMs() {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return (tv.tv_sec * 1000.0) + (tv.tv_usec / 1000.0);
-}
-
 void printSeparator() {
     printf("\n");
     for (int i = 0; i < SEPARATOR_LENGTH; i++) printf("=");
@@ -61,23 +158,62 @@ void printHeader(const char* title) {
     printSeparator();
 }
 
+unsigned int detectCpuCount() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    return (cpus > SORTLIB_MAX_THREADS) ? SORTLIB_MAX_THREADS : (unsigned int)cpus;
+}
+
+// Thread counts for scaling runs: 1, 2, 4, ... and always maxThreads last
+unsigned int nextThreadCount(unsigned int threads, unsigned int maxThreads) {
+    if (threads < maxThreads && threads * 2 > maxThreads) return maxThreads;
+    return threads * 2;
+}
+
 // ============================================================================
 // DISPLAY FUNCTIONS
 // ============================================================================
 
-void printArray(int* arr, unsigned int size) {
+void printArray(int* arr, size_t size) {
     printf("Array: [");
-    unsigned int displaySize = (size > MAX_DISPLAY_SIZE) ? MAX_DISPLAY_SIZE : size;
+    size_t displaySize = (size > MAX_DISPLAY_SIZE) ? MAX_DISPLAY_SIZE : size;
     
-    for (unsigned int i = 0; i < displaySize; i++) {
+    for (size_t i = 0; i < displaySize; i++) {
         printf("%d", arr[i]);
         if (i < displaySize - 1) printf(", ");
     }
     
     if (size > MAX_DISPLAY_SIZE) {
-        printf(" ... (%u more elements)", size - MAX_DISPLAY_SIZE);
+        printf(" ... (%zu more elements)", size - MAX_DISPLAY_SIZE);
+    }
+    printf("]\n");
+}
+
+// Distinct values of the array with their multiplicities, in sort order
+void printDistinctCounts(const int* arr, size_t size, bool ascending) {
+    int* values = malloc(size * sizeof(int));
+    size_t* counts = malloc(size * sizeof(size_t));
+    if (!values || !counts) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    
+    sortlib_Stats stats;
+    size_t distinct = sortlib_countDistinctInts(arr, size, ascending, values, counts, &stats);
+    size_t displaySize = (distinct > MAX_DISPLAY_SIZE) ? MAX_DISPLAY_SIZE : distinct;
+    
+    printf("Distinct values (%zu): [", distinct);
+    for (size_t i = 0; i < displaySize; i++) {
+        printf("%d x%zu", values[i], counts[i]);
+        if (i < displaySize - 1) printf(", ");
+    }
+    if (distinct > MAX_DISPLAY_SIZE) {
+        printf(" ... (%zu more values)", distinct - MAX_DISPLAY_SIZE);
     }
     printf("]\n");
+    
+    free(counts);
+    free(values);
 }
 
 void printMatrix(char** matrix, unsigned int rows) {
@@ -87,7 +223,24 @@ void printMatrix(char** matrix, unsigned int rows) {
     }
 }
 
-void printList(Node* head) {
+void printIntMatrix(const sortlib_IntMatrix* table) {
+    printf("Table (%zu x %zu):\n", table->rows, table->cols);
+    size_t displayRows = (table->rows > MAX_DISPLAY_SIZE) ? MAX_DISPLAY_SIZE : table->rows;
+    
+    for (size_t r = 0; r < displayRows; r++) {
+        printf("  [%zu]:", r);
+        for (size_t c = 0; c < table->cols; c++) {
+            printf(" %6d", table->data[r * table->cols + c]);
+        }
+        printf("\n");
+    }
+    
+    if (table->rows > MAX_DISPLAY_SIZE) {
+        printf("  ... (%zu more rows)\n", table->rows - MAX_DISPLAY_SIZE);
+    }
+}
+
+void printList(sortlib_Node* head) {
     printf("List: ");
     unsigned int count = 0;
     while (head != NULL && count < MAX_DISPLAY_SIZE) {
@@ -102,7 +255,7 @@ void printList(Node* head) {
     printf(" -> NULL\n");
 }
 
-void printStats(const SortStats* stats, bool showTime) {
+void printStats(const sortlib_Stats* stats, bool showTime) {
     printf("Comparisons: %llu\n", stats->comparisons);
     printf("Swaps: %llu\n", stats->swaps);
     if (showTime) {
@@ -110,28 +263,84 @@ void printStats(const SortStats* stats, bool showTime) {
     }
 }
 
-// ============================================================================
-// SWAP FUNCTIONS
-// ============================================================================
-
-void swap(int* a, int* b) {
-    int temp = *a;
-    *a = *b;
-    *b = temp;
+// Step visualization: consoleObserver reports here when steps are shown
+void printSortStep(void* context, const sortlib_Step* step) {
+    (void)context;
+    bool ints = step->dataKind == SORTLIB_DATA_INTS;
+    
+    switch (step->kind) {
+        case SORTLIB_STEP_START:
+            printHeader(step->algorithm);
+            printf("Order: %s", step->ascending ? "Ascending" : "Descending");
+            if (step->first) printf(", Arity: %zu", step->first);
+            if (step->second) printf(", Threads: %zu", step->second);
+            printf("\n");
+            break;
+        case SORTLIB_STEP_SWAP:
+            if (ints) {
+                printf("Step %zu (Swap %zu): ", step->first, step->second);
+            } else {
+                printf("Step %zu (Swap):", step->second);
+            }
+            break;
+        case SORTLIB_STEP_INSERT:
+            if (ints) {
+                printf("Step %zu (Insert %lld): ", step->first, step->value);
+            } else {
+                printf("Step %zu:", step->first);
+            }
+            break;
+        case SORTLIB_STEP_MERGE:
+            printf("Merge step [%zu-%zu]: ", step->first, step->second);
+            break;
+        case SORTLIB_STEP_PIVOT:
+            printf("Pivot step: ");
+            break;
+        case SORTLIB_STEP_GAP:
+            printf("Step (gap=%zu): ", step->first);
+            break;
+        case SORTLIB_STEP_HEAP_BUILT:
+            printf("Heap built: ");
+            break;
+        case SORTLIB_STEP_EXTRACT:
+            printf("Extract step %zu: ", step->first);
+            break;
+        case SORTLIB_STEP_SORTED:
+            printf("No more swaps needed. Array is sorted!\n");
+            return;
+        case SORTLIB_STEP_SPLIT:
+            printf("Split on byte %zu into %zu buckets:", step->first, step->second);
+            break;
+        case SORTLIB_STEP_RANGE:
+            printf("Counted keys %lld..%lld (%zu counters): ", step->value,
+                   step->value + (long long)step->first - 1, step->first);
+            break;
+        case SORTLIB_STEP_RUN:
+            printf("Wrote %lld x%zu: ", step->value, step->first);
+            break;
+        case SORTLIB_STEP_KEYS:
+            printf("Collation keys built (%zu bytes):", step->first);
+            break;
+    }
+    
+    if (step->dataKind == SORTLIB_DATA_INTS) {
+        printArray((int*)step->data, step->length);
+    } else if (step->dataKind == SORTLIB_DATA_STRINGS) {
+        if (step->kind != SORTLIB_STEP_START) printf("\n");
+        printMatrix((char**)step->data, (unsigned int)step->length);
+    } else {
+        if (step->kind != SORTLIB_STEP_START) printf(" ");
+        printList((sortlib_Node*)step->data);
+    }
 }
 
-void swapStrings(char* a, char* b) {
-    char temp[MAX_STRING_LENGTH];
-    strcpy(temp, a);
-    strcpy(a, b);
-    strcpy(b, temp);
-}
+const sortlib_Observer consoleObserver = {printSortStep, NULL, NULL};
 
 // ============================================================================
 // DATA GENERATION FUNCTIONS
 // ============================================================================
 
-int* generateRandomArray(unsigned int size) {
+int* generateRandomArray(size_t size) {
     int* arr = malloc(size * sizeof(int));
     if (!arr) {
         printf("Memory allocation failed\n");
@@ -139,27 +348,36 @@ int* generateRandomArray(unsigned int size) {
     }
     
     srand(time(NULL));
-    for (unsigned int i = 0; i < size; i++) {
+    for (size_t i = 0; i < size; i++) {
         arr[i] = rand() % 10000;
     }
     return arr;
 }
 
-int* getUserArray(unsigned int size) {
+int* getUserArray(size_t size) {
     int* arr = malloc(size * sizeof(int));
     if (!arr) {
         printf("Memory allocation failed\n");
         exit(1);
     }
     
-    printf("Enter %u integers:\n", size);
-    for (unsigned int i = 0; i < size; i++) {
-        printf("Enter value %u: ", i + 1);
+    printf("Enter %zu integers:\n", size);
+    for (size_t i = 0; i < size; i++) {
+        printf("Enter value %zu: ", i + 1);
         scanf("%d", &arr[i]);
     }
     return arr;
 }
 
+// rand() only guarantees 15 random bits per call
+uint64_t randomBits64() {
+    uint64_t bits = 0;
+    for (int i = 0; i < 5; i++) {
+        bits = (bits << 15) ^ (uint64_t)(rand() & 0x7FFF);
+    }
+    return bits;
+}
+
 char** generateRandomMatrix(unsigned int rows) {
     char** matrix = malloc(rows * sizeof(char*));
     if (!matrix) {
@@ -169,7 +387,7 @@ char** generateRandomMatrix(unsigned int rows) {
     
     srand(time(NULL));
     for (unsigned int i = 0; i < rows; i++) {
-        matrix[i] = malloc(MAX_STRING_LENGTH * sizeof(char));
+        matrix[i] = malloc(SORTLIB_STRING_LENGTH * sizeof(char));
         if (!matrix[i]) {
             printf("Memory allocation failed\n");
             exit(1);
@@ -186,9 +404,9 @@ char** getUserMatrix(unsigned int rows) {
         exit(1);
     }
     
-    printf("Enter %u strings (max %d characters each):\n", rows, MAX_STRING_LENGTH - 1);
+    printf("Enter %u strings (max %d characters each):\n", rows, SORTLIB_STRING_LENGTH - 1);
     for (unsigned int i = 0; i < rows; i++) {
-        matrix[i] = malloc(MAX_STRING_LENGTH * sizeof(char));
+        matrix[i] = malloc(SORTLIB_STRING_LENGTH * sizeof(char));
         if (!matrix[i]) {
             printf("Memory allocation failed\n");
             exit(1);
@@ -199,8 +417,52 @@ char** getUserMatrix(unsigned int rows) {
     return matrix;
 }
 
-Node* createNode(const char* info) {
-    Node* newNode = malloc(sizeof(Node));
+// Returns NULL when rows * cols ints do not fit in size_t
+sortlib_IntMatrix* createIntMatrix(size_t rows, size_t cols) {
+    if (cols != 0 && rows > SIZE_MAX / sizeof(int) / cols) {
+        printf("Table too large!\n");
+        return NULL;
+    }
+    sortlib_IntMatrix* table = malloc(sizeof(sortlib_IntMatrix));
+    int* data = malloc(rows * cols * sizeof(int));
+    if (!table || !data) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    table->data = data;
+    table->rows = rows;
+    table->cols = cols;
+    return table;
+}
+
+// Small value range so rows tie on leading keys and later keys matter
+sortlib_IntMatrix* generateRandomIntMatrix(size_t rows, size_t cols) {
+    sortlib_IntMatrix* table = createIntMatrix(rows, cols);
+    if (!table) return NULL;
+    
+    srand(time(NULL));
+    for (size_t i = 0; i < rows * cols; i++) {
+        table->data[i] = rand() % 100;
+    }
+    return table;
+}
+
+sortlib_IntMatrix* getUserIntMatrix(size_t rows, size_t cols) {
+    sortlib_IntMatrix* table = createIntMatrix(rows, cols);
+    if (!table) return NULL;
+    
+    printf("Enter %zu rows of %zu integers:\n", rows, cols);
+    for (size_t r = 0; r < rows; r++) {
+        printf("Enter row %zu: ", r + 1);
+        for (size_t c = 0; c < cols; c++) {
+            scanf("%d", &table->data[r * cols + c]);
+        }
+    }
+    return table;
+}
+
+sortlib_Node* createNode(const char* info) {
+    sortlib_Node* newNode = malloc(sizeof(sortlib_Node));
     if (!newNode) {
         printf("Memory allocation failed\n");
         exit(1);
@@ -210,15 +472,15 @@ Node* createNode(const char* info) {
     return newNode;
 }
 
-Node* generateRandomList(unsigned int size) {
-    Node* head = NULL;
-    Node* tail = NULL;
+sortlib_Node* generateRandomList(unsigned int size) {
+    sortlib_Node* head = NULL;
+    sortlib_Node* tail = NULL;
     srand(time(NULL));
     
     for (unsigned int i = 0; i < size; i++) {
-        char word[MAX_STRING_LENGTH];
+        char word[SORTLIB_STRING_LENGTH];
         sprintf(word, "word%u", rand() % 10000);
-        Node* newNode = createNode(word);
+        sortlib_Node* newNode = createNode(word);
         
         if (head == NULL) {
             head = newNode;
@@ -231,16 +493,16 @@ Node* generateRandomList(unsigned int size) {
     return head;
 }
 
-Node* getUserList(unsigned int size) {
-    Node* head = NULL;
-    Node* tail = NULL;
+sortlib_Node* getUserList(unsigned int size) {
+    sortlib_Node* head = NULL;
+    sortlib_Node* tail = NULL;
     
     printf("Enter %u strings:\n", size);
     for (unsigned int i = 0; i < size; i++) {
-        char word[MAX_STRING_LENGTH];
+        char word[SORTLIB_STRING_LENGTH];
         printf("Enter string %u: ", i + 1);
         scanf("%s", word);
-        Node* newNode = createNode(word);
+        sortlib_Node* newNode = createNode(word);
         
         if (head == NULL) {
             head = newNode;
@@ -257,8 +519,8 @@ Node* getUserList(unsigned int size) {
 // MEMORY MANAGEMENT
 // ============================================================================
 
-void freeList(Node* head) {
-    Node* temp;
+void freeList(sortlib_Node* head) {
+    sortlib_Node* temp;
     while (head != NULL) {
         temp = head;
         head = head->next;
@@ -273,412 +535,1554 @@ void freeMatrix(char** matrix, unsigned int rows) {
     free(matrix);
 }
 
-// ============================================================================
-// SORTING ALGORITHMS - ARRAYS
-// ============================================================================
+void freeIntMatrix(sortlib_IntMatrix* table) {
+    free(table->data);
+    free(table);
+}
 
-void bubbleSortArray(int* arr, unsigned int size, bool ascending, SortStats* stats, bool showSteps) {
-    stats->comparisons = 0;
-    stats->swaps = 0;
-    double startTime = getTimeMs();
-    
-    if (showSteps) {
-        printHeader("BUBBLE SORT");
-        printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-        printArray(arr, size);
-    }
-    
-    bool swapped;
-    for (unsigned int i = 0; i < size - 1; i++) {
-        swapped = false;
-        for (unsigned int j = 0; j < size - i - 1; j++) {
-            stats->comparisons++;
-            if ((ascending && arr[j] > arr[j + 1]) || (!ascending && arr[j] < arr[j + 1])) {
-                swap(&arr[j], &arr[j + 1]);
-                stats->swaps++;
-                swapped = true;
-                if (showSteps) {
-                    printf("Step %u (Swap %llu): ", i + 1, stats->swaps);
-                    printArray(arr, size);
-                }
+// Linux resets the peak RSS (VmHWM) on "5" written to clear_refs; elsewhere,
+// or when that is not permitted, the peak covers the whole process lifetime
+void resetPeakRss() {
+#ifdef __linux__
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file) {
+        fputs("5", file);
+        fclose(file);
+    }
+#endif
+}
+
+long readPeakRssKb() {
+#ifdef __linux__
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        long peak = -1;
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                peak = strtol(line + 6, NULL, 10);
+                break;
             }
         }
-        if (!swapped && showSteps) {
-            printf("No more swaps needed. Array is sorted!\n");
-            break;
-        }
+        fclose(file);
+        if (peak >= 0) return peak;
     }
-    
-    stats->execution_time_ms = getTimeMs() - startTime;
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
 }
 
-void selectionSortArray(int* arr, unsigned int size, bool ascending, SortStats* stats, bool showSteps) {
-    stats->comparisons = 0;
-    stats->swaps = 0;
-    double startTime = getTimeMs();
-    
-    if (showSteps) {
-        printHeader("SELECTION SORT");
-        printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-        printArray(arr, size);
+// Brackets one measured sort: the library's scratch counters plus the peak
+// RSS, which only the harness may reset since it covers the whole process
+void beginMemoryMeasurement() {
+    sortlib_beginScratchMeasurement();
+    resetPeakRss();
+}
+
+void endMemoryMeasurement(sortlib_Stats* stats) {
+    sortlib_endScratchMeasurement(stats);
+    stats->peakRssKb = readPeakRssKb();
+}
+
+// ============================================================================
+// STEP TRACE RECORDER
+// ============================================================================
+
+// The traced sort gets the tracer's observer instead of the console one and
+// logs compact events here instead of printing every step
+void traceEvent(void* context, sortlib_Operation op, uint64_t first, uint64_t second) {
+    StepTracer* tracer = context;
+    size_t head = atomic_load_explicit(&tracer->head, memory_order_relaxed);
+    
+    // Ring full: wait for the writer rather than drop events
+    while (head - atomic_load_explicit(&tracer->tail, memory_order_acquire) == TRACE_RING_CAPACITY) {
+        sched_yield();
     }
-    
-    for (unsigned int i = 0; i < size - 1; i++) {
-        unsigned int extreme = i;
-        
-        for (unsigned int j = i + 1; j < size; j++) {
-            stats->comparisons++;
-            if ((ascending && arr[j] < arr[extreme]) || (!ascending && arr[j] > arr[extreme])) {
-                extreme = j;
+    TraceEvent* event = &tracer->events[head & (TRACE_RING_CAPACITY - 1)];
+    event->opAndFirst = ((uint64_t)op << 56) | (first & 0x00FFFFFFFFFFFFFFULL);
+    event->second = second;
+    atomic_store_explicit(&tracer->head, head + 1, memory_order_release);
+    tracer->recorded++;
+}
+
+void* traceWriter(void* arg) {
+    StepTracer* tracer = arg;
+    
+    while (true) {
+        size_t tail = atomic_load_explicit(&tracer->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&tracer->head, memory_order_acquire);
+        if (head == tail) {
+            if (atomic_load_explicit(&tracer->done, memory_order_acquire) &&
+                atomic_load_explicit(&tracer->head, memory_order_acquire) == tail) {
+                break;
             }
+            struct timespec pause = {0, 50000};
+            nanosleep(&pause, NULL);
+            continue;
         }
         
-        if (extreme != i) {
-            swap(&arr[extreme], &arr[i]);
-            stats->swaps++;
-            if (showSteps) {
-                printf("Step %u (Swap %llu): ", i + 1, stats->swaps);
-                printArray(arr, size);
-            }
+        // Write the contiguous part up to the ring's wrap point
+        size_t start = tail & (TRACE_RING_CAPACITY - 1);
+        size_t count = head - tail;
+        if (count > TRACE_RING_CAPACITY - start) count = TRACE_RING_CAPACITY - start;
+        // After a failed write keep draining, so the sort does not wait on a full ring
+        if (!tracer->failed && fwrite(&tracer->events[start], sizeof(TraceEvent), count, tracer->file) != count) {
+            tracer->failed = true;
         }
+        atomic_store_explicit(&tracer->tail, tail + count, memory_order_release);
     }
-    
-    stats->execution_time_ms = getTimeMs() - startTime;
+    return NULL;
 }
 
-void insertionSortArray(int* arr, unsigned int size, bool ascending, SortStats* stats, bool showSteps) {
-    stats->comparisons = 0;
-    stats->swaps = 0;
-    double startTime = getTimeMs();
+// Writes the header and initial array, then starts the writer thread.
+// Returns NULL, with the file closed, when the trace cannot be started.
+StepTracer* startStepTrace(const char* path, const int* arr, size_t size) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        printf("Could not create trace file %s\n", path);
+        return NULL;
+    }
     
-    if (showSteps) {
-        printHeader("INSERTION SORT");
-        printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-        printArray(arr, size);
+    uint32_t version = TRACE_VERSION;
+    uint64_t count = size;
+    StepTracer* tracer = NULL;
+    TraceEvent* events = NULL;
+    if (fwrite(TRACE_MAGIC, 1, 4, file) != 4 || fwrite(&version, sizeof(version), 1, file) != 1 ||
+        fwrite(&count, sizeof(count), 1, file) != 1 || fwrite(arr, sizeof(int), size, file) != size) {
+        printf("Could not write trace file %s\n", path);
+        goto failed;
     }
     
-    for (unsigned int i = 1; i < size; i++) {
-        int key = arr[i];
-        int j = i - 1;
-        
-        while (j >= 0 && ((ascending && arr[j] > key) || (!ascending && arr[j] < key))) {
-            arr[j + 1] = arr[j];
-            j--;
-            stats->comparisons++;
-            stats->swaps++;
-        }
-        stats->comparisons++;
-        arr[j + 1] = key;
-        if (showSteps) {
-            printf("Step %u (Insert %d): ", i, key);
-            printArray(arr, size);
-        }
+    tracer = malloc(sizeof(StepTracer));
+    events = malloc(TRACE_RING_CAPACITY * sizeof(TraceEvent));
+    if (!tracer || !events) {
+        printf("Memory allocation failed\n");
+        goto failed;
     }
+    tracer->events = events;
+    atomic_init(&tracer->head, 0);
+    atomic_init(&tracer->tail, 0);
+    atomic_init(&tracer->done, false);
+    tracer->file = file;
+    tracer->recorded = 0;
+    tracer->failed = false;
+    tracer->observer.onStep = NULL;
+    tracer->observer.onOperation = traceEvent;
+    tracer->observer.context = tracer;
+    
+    if (pthread_create(&tracer->writer, NULL, traceWriter, tracer) != 0) {
+        printf("Failed to start trace writer thread\n");
+        goto failed;
+    }
+    return tracer;
     
-    stats->execution_time_ms = getTimeMs() - startTime;
+failed:
+    free(events);
+    free(tracer);
+    fclose(file);
+    return NULL;
 }
 
-void merge(int* arr, int left, int mid, int right, bool ascending, SortStats* stats, bool showSteps) {
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
-    
-    int* L = malloc(n1 * sizeof(int));
-    int* R = malloc(n2 * sizeof(int));
-    
-    for (int i = 0; i < n1; i++) L[i] = arr[left + i];
-    for (int j = 0; j < n2; j++) R[j] = arr[mid + 1 + j];
-    
-    int i = 0, j = 0, k = left;
-    
-    while (i < n1 && j < n2) {
-        stats->comparisons++;
-        if ((ascending && L[i] <= R[j]) || (!ascending && L[i] >= R[j])) {
-            arr[k] = L[i];
-            i++;
-        } else {
-            arr[k] = R[j];
-            j++;
-            stats->swaps++;
-        }
-        k++;
+// Drains the remaining events and closes the file. Stores the event count;
+// returns false when a write failed, leaving the trace incomplete.
+bool stopStepTrace(StepTracer* tracer, unsigned long long* recorded) {
+    atomic_store_explicit(&tracer->done, true, memory_order_release);
+    pthread_join(tracer->writer, NULL);
+    bool written = !tracer->failed;
+    if (fclose(tracer->file) != 0) written = false;
+    
+    *recorded = tracer->recorded;
+    free(tracer->events);
+    free(tracer);
+    return written;
+}
+
+// Rebuilds the array states from a trace and prints every stride-th change
+void replayStepTrace(const char* path, unsigned long long stride) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("Could not open trace file %s\n", path);
+        return;
     }
     
-    while (i < n1) {
-        arr[k] = L[i];
-        i++; k++;
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, TRACE_MAGIC, 4) != 0 ||
+        fread(&version, sizeof(version), 1, file) != 1 || version != TRACE_VERSION ||
+        fread(&count, sizeof(count), 1, file) != 1) {
+        printf("%s is not a step trace file\n", path);
+        fclose(file);
+        return;
     }
     
-    while (j < n2) {
-        arr[k] = R[j];
-        j++; k++;
+    size_t size = (size_t)count;
+    int* arr = malloc((size ? size : 1) * sizeof(int));
+    if (!arr) {
+        printf("Memory allocation failed\n");
+        exit(1);
     }
+    if (fread(arr, sizeof(int), size, file) != size) {
+        printf("Trace file is truncated\n");
+        free(arr);
+        fclose(file);
+        return;
+    }
+    
+    printf("Initial state: ");
+    printArray(arr, size);
     
-    if (showSteps) {
-        printf("Merge step [%d-%d]: ", left, right);
-        printArray(arr, right + 1);
+    unsigned long long compares = 0, swaps = 0, writes = 0, changes = 0;
+    TraceEvent events[4096];
+    size_t read;
+    while ((read = fread(events, sizeof(TraceEvent), 4096, file)) > 0) {
+        for (size_t e = 0; e < read; e++) {
+            sortlib_Operation op = (sortlib_Operation)(events[e].opAndFirst >> 56);
+            size_t first = (size_t)(events[e].opAndFirst & 0x00FFFFFFFFFFFFFFULL);
+            uint64_t second = events[e].second;
+            
+            if (op == SORTLIB_OP_COMPARE) {
+                compares++;
+                continue;
+            }
+            if (first >= size || (op == SORTLIB_OP_SWAP && second >= size)) {
+                printf("Corrupt event %llu, stopping replay\n", compares + swaps + writes);
+                goto done;
+            }
+            if (op == SORTLIB_OP_SWAP) {
+                int temp = arr[first];
+                arr[first] = arr[second];
+                arr[second] = temp;
+                swaps++;
+            } else {
+                arr[first] = (int)(int64_t)second;
+                writes++;
+            }
+            
+            if (++changes % stride == 0) {
+                if (op == SORTLIB_OP_SWAP) {
+                    printf("Step %llu (Swap %zu <-> %zu): ", changes, first, (size_t)second);
+                } else {
+                    printf("Step %llu (Write [%zu] = %d): ", changes, first, arr[first]);
+                }
+                printArray(arr, size);
+            }
+        }
     }
     
-    free(L); free(R);
+done:
+    printf("Final state: ");
+    printArray(arr, size);
+    printf("Replayed %llu comparisons, %llu swaps, %llu writes\n", compares, swaps, writes);
+    
+    free(arr);
+    fclose(file);
 }
 
-void mergeSortArray(int* arr, int left, int right, bool ascending, SortStats* stats, bool showSteps) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
-        mergeSortArray(arr, left, mid, ascending, stats, showSteps);
-        mergeSortArray(arr, mid + 1, right, ascending, stats, showSteps);
-        merge(arr, left, mid, right, ascending, stats, showSteps);
+// ============================================================================
+// BENCHMARK RESULT STORE
+// ============================================================================
+
+BenchmarkRun currentRun;
+
+// Commas would break the CSV layout, newlines the record boundaries
+void sanitizeField(char* field) {
+    for (char* p = field; *p; p++) {
+        if (*p == ',' || *p == '\n' || *p == '\r') *p = ' ';
     }
+    if (field[0] == '\0') strcpy(field, "unknown");
 }
 
-void quickSortArray(int* arr, int low, int high, bool ascending, SortStats* stats, bool showSteps) {
-    if (low < high) {
-        int pivot = arr[high];
-        int i = low - 1;
-        
-        for (int j = low; j < high; j++) {
-            stats->comparisons++;
-            if ((ascending && arr[j] < pivot) || (!ascending && arr[j] > pivot)) {
-                i++;
-                swap(&arr[i], &arr[j]);
-                stats->swaps++;
+void detectCpuModel(char* out, size_t length) {
+    snprintf(out, length, "unknown");
+    FILE* file = fopen("/proc/cpuinfo", "r");
+    if (!file) return;
+    
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "model name", 10) == 0) {
+            char* value = strchr(line, ':');
+            if (value) {
+                value++;
+                while (*value == ' ' || *value == '\t') value++;
+                snprintf(out, length, "%s", value);
+                out[strcspn(out, "\n")] = '\0';
             }
+            break;
         }
-        swap(&arr[i + 1], &arr[high]);
-        stats->swaps++;
-        
-        if (showSteps) {
-            printf("Pivot step: ");
-            printArray(arr, high + 1);
-        }
-        
-        quickSortArray(arr, low, i, ascending, stats, showSteps);
-        quickSortArray(arr, i + 2, high, ascending, stats, showSteps);
     }
+    fclose(file);
 }
 
-void combSortArray(int* arr, unsigned int size, bool ascending, SortStats* stats, bool showSteps) {
-    stats->comparisons = 0;
-    stats->swaps = 0;
-    double startTime = getTimeMs();
-    
-    if (showSteps) {
-        printHeader("COMB SORT");
-        printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-        printArray(arr, size);
+void detectGitRevision(char* out, size_t length) {
+    snprintf(out, length, "%s", GIT_REVISION);
+    if (strcmp(out, "unknown") != 0) return;
+    
+    FILE* pipe = popen("git rev-parse --short HEAD 2>/dev/null", "r");
+    if (!pipe) return;
+    if (fgets(out, length, pipe)) {
+        out[strcspn(out, "\n")] = '\0';
     }
-    
-    int gap = size;
-    bool swapped = true;
-    
-    while (gap > 1 || swapped) {
-        gap = (gap * 10) / 13;
-        if (gap < 1) gap = 1;
-        swapped = false;
-        
-        for (unsigned int i = 0; i + gap < size; i++) {
-            int j = i + gap;
-            stats->comparisons++;
-            if ((ascending && arr[i] > arr[j]) || (!ascending && arr[i] < arr[j])) {
-                swap(&arr[i], &arr[j]);
-                stats->swaps++;
-                swapped = true;
-                if (showSteps) {
-                    printf("Step (gap=%d): ", gap);
-                    printArray(arr, size);
-                }
-            }
-        }
+    if (out[0] == '\0') snprintf(out, length, "unknown");
+    pclose(pipe);
+}
+
+// True when RESULTS_FILE already holds records of runId
+bool benchmarkRunExists(const char* runId) {
+    FILE* file = fopen(RESULTS_FILE, "r");
+    if (!file) return false;
+    
+    size_t length = strlen(runId);
+    char line[1024];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), file)) {
+        found = strncmp(line, runId, length) == 0 && line[length] == ',';
     }
-    
-    stats->execution_time_ms = getTimeMs() - startTime;
+    fclose(file);
+    return found;
 }
 
-// ============================================================================
-// SORTING ALGORITHMS - MATRICES
-// ============================================================================
+// Starts a new run id; every record appended afterwards belongs to it. Ids
+// carry milliseconds, and a sequence suffix if the id is still taken, so two
+// runs never pool their samples in the comparison.
+void beginBenchmarkRun() {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now.tv_sec));
+    long milliseconds = now.tv_nsec / 1000000;
+    snprintf(currentRun.runId, sizeof(currentRun.runId), "%s.%03ld", stamp, milliseconds);
+    for (unsigned int sequence = 2; benchmarkRunExists(currentRun.runId); sequence++) {
+        snprintf(currentRun.runId, sizeof(currentRun.runId), "%s.%03ld-%u", stamp, milliseconds, sequence);
+    }
+    detectCpuModel(currentRun.cpuModel, sizeof(currentRun.cpuModel));
+#ifdef __VERSION__
+    snprintf(currentRun.compiler, sizeof(currentRun.compiler), "%s", __VERSION__);
+#else
+    snprintf(currentRun.compiler, sizeof(currentRun.compiler), "unknown");
+#endif
+    snprintf(currentRun.buildFlags, sizeof(currentRun.buildFlags), "%s", BUILD_FLAGS);
+    detectGitRevision(currentRun.gitRevision, sizeof(currentRun.gitRevision));
+    
+    sanitizeField(currentRun.cpuModel);
+    sanitizeField(currentRun.compiler);
+    sanitizeField(currentRun.buildFlags);
+    sanitizeField(currentRun.gitRevision);
+    
+    printf("Benchmark run %s (results appended to %s)\n", currentRun.runId, RESULTS_FILE);
+}
 
-void bubbleSortMatrix(char** matrix, unsigned int rows, bool ascending, SortStats* stats, bool showSteps) {
-    stats->comparisons = 0;
-    stats->swaps = 0;
-    double startTime = getTimeMs();
-    
-    if (showSteps) {
-        printHeader("BUBBLE SORT - MATRIX");
-        printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-        printMatrix(matrix, rows);
+void recordBenchmarkResult(const char* algorithm, const char* distribution, size_t size,
+                           unsigned int threads, bool ascending, const sortlib_Stats* stats) {
+    FILE* file = fopen(RESULTS_FILE, "a");
+    if (!file) {
+        printf("Warning: could not open %s for writing\n", RESULTS_FILE);
+        return;
     }
     
-    bool swapped;
-    do {
-        swapped = false;
-        for (unsigned int i = 0; i < rows - 1; i++) {
-            stats->comparisons++;
-            if ((ascending && strcmp(matrix[i], matrix[i + 1]) > 0) ||
-                (!ascending && strcmp(matrix[i], matrix[i + 1]) < 0)) {
-                swapStrings(matrix[i], matrix[i + 1]);
-                stats->swaps++;
-                swapped = true;
-                if (showSteps) {
-                    printf("Step %llu (Swap):\n", stats->swaps);
-                    printMatrix(matrix, rows);
-                }
-            }
-        }
-    } while (swapped);
-    
-    stats->execution_time_ms = getTimeMs() - startTime;
+    // A fresh file gets the header line first
+    if (ftell(file) == 0) {
+        fprintf(file, "run_id,algorithm,distribution,order,size,threads,time_ms,comparisons,swaps,"
+                      "cpu_model,compiler,build_flags,git_revision,"
+                      "bytes_allocated,allocations,peak_heap_bytes,peak_rss_kb\n");
+    }
+    fprintf(file, "%s,%s,%s,%s,%zu,%u,%.6f,%llu,%llu,%s,%s,%s,%s,%llu,%llu,%zu,%ld\n",
+            currentRun.runId, algorithm, distribution, ascending ? "asc" : "desc", size, threads,
+            stats->execution_time_ms, stats->comparisons, stats->swaps,
+            currentRun.cpuModel, currentRun.compiler, currentRun.buildFlags, currentRun.gitRevision,
+            stats->bytesAllocated, stats->allocations, stats->peakHeapBytes, stats->peakRssKb);
+    fclose(file);
 }
 
-// ============================================================================
-// SORTING ALGORITHMS - LINKED LISTS
-// ============================================================================
+// Splits one CSV line in place; returns the number of fields found
+int splitCsvLine(char* line, char** fields, int maxFields) {
+    int count = 0;
+    line[strcspn(line, "\r\n")] = '\0';
+    
+    char* start = line;
+    while (count < maxFields) {
+        fields[count++] = start;
+        char* comma = strchr(start, ',');
+        if (!comma) break;
+        *comma = '\0';
+        start = comma + 1;
+    }
+    return count;
+}
 
-void bubbleSortList(Node** head, bool ascending, SortStats* stats, bool showSteps) {
-    if (*head == NULL) return;
-    
-    stats->comparisons = 0;
-    stats->swaps = 0;
-    double startTime = getTimeMs();
-    
-    if (showSteps) {
-        printHeader("BUBBLE SORT - LINKED LIST");
-        printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-        printList(*head);
+BenchmarkRecord* loadBenchmarkRecords(size_t* count) {
+    *count = 0;
+    FILE* file = fopen(RESULTS_FILE, "r");
+    if (!file) return NULL;
+    
+    size_t capacity = 256;
+    BenchmarkRecord* records = malloc(capacity * sizeof(BenchmarkRecord));
+    if (!records) {
+        printf("Memory allocation failed\n");
+        exit(1);
     }
     
-    bool swapped;
-    Node** current;
-    
-    do {
-        swapped = false;
-        current = head;
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        char* fields[13];
+        if (strncmp(line, "run_id,", 7) == 0) continue;
+        if (splitCsvLine(line, fields, 13) < 9) continue;
         
-        while ((*current)->next != NULL) {
-            Node* a = *current;
-            Node* b = a->next;
-            
-            stats->comparisons++;
-            if ((ascending && strcmp(a->info, b->info) > 0) ||
-                (!ascending && strcmp(a->info, b->info) < 0)) {
-                a->next = b->next;
-                b->next = a;
-                *current = b;
-                stats->swaps++;
-                swapped = true;
-                if (showSteps) {
-                    printf("Step %llu (Swap): ", stats->swaps);
-                    printList(*head);
-                }
+        if (*count == capacity) {
+            capacity *= 2;
+            BenchmarkRecord* grown = realloc(records, capacity * sizeof(BenchmarkRecord));
+            if (!grown) {
+                printf("Memory allocation failed\n");
+                exit(1);
             }
-            current = &(*current)->next;
+            records = grown;
         }
-    } while (swapped);
-    
-    stats->execution_time_ms = getTimeMs() - startTime;
+        BenchmarkRecord* r = &records[(*count)++];
+        snprintf(r->runId, sizeof(r->runId), "%s", fields[0]);
+        snprintf(r->algorithm, sizeof(r->algorithm), "%s", fields[1]);
+        snprintf(r->distribution, sizeof(r->distribution), "%s", fields[2]);
+        snprintf(r->order, sizeof(r->order), "%s", fields[3]);
+        r->size = strtoull(fields[4], NULL, 10);
+        r->threads = (unsigned int)strtoul(fields[5], NULL, 10);
+        r->timeMs = strtod(fields[6], NULL);
+        r->comparisons = strtoull(fields[7], NULL, 10);
+        r->swaps = strtoull(fields[8], NULL, 10);
+    }
+    fclose(file);
+    return records;
+}
+
+bool sameBenchmarkCase(const BenchmarkRecord* a, const BenchmarkRecord* b) {
+    return strcmp(a->algorithm, b->algorithm) == 0 &&
+           strcmp(a->distribution, b->distribution) == 0 &&
+           strcmp(a->order, b->order) == 0 &&
+           a->size == b->size && a->threads == b->threads;
+}
+
+// Mean and sample standard deviation of one case within one run
+void summarizeBenchmarkCase(const BenchmarkRecord* records, size_t count, const char* runId,
+                            const BenchmarkRecord* key, unsigned int* n, double* mean, double* stddev) {
+    double sum = 0.0, sumSquares = 0.0;
+    *n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(records[i].runId, runId) != 0 || !sameBenchmarkCase(&records[i], key)) continue;
+        sum += records[i].timeMs;
+        sumSquares += records[i].timeMs * records[i].timeMs;
+        (*n)++;
+    }
+    *mean = *n ? sum / *n : 0.0;
+    double variance = (*n > 1) ? (sumSquares - sum * *mean) / (*n - 1) : 0.0;
+    *stddev = variance > 0.0 ? sqrt(variance) : 0.0;
+}
+
+// One-sided 95% critical values of Student's t for 1..30 degrees of freedom
+double tCritical95(double degrees) {
+    static const double table[] = {
+        6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+        1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+        1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697
+    };
+    int df = (int)degrees;
+    if (df < 1) df = 1;
+    return (df <= 30) ? table[df - 1] : 1.645;
 }
 
-void insertionSortList(Node** head, bool ascending, SortStats* stats, bool showSteps) {
-    if (*head == NULL) return;
+void compareBenchmarkRuns() {
+    clearScreen();
+    printHeader("COMPARE BENCHMARK RUNS");
     
-    stats->comparisons = 0;
-    stats->swaps = 0;
-    double startTime = getTimeMs();
+    size_t count;
+    BenchmarkRecord* records = loadBenchmarkRecords(&count);
+    if (count == 0) {
+        printf("No results found in %s. Run the performance testing mode first.\n", RESULTS_FILE);
+        free(records);
+        return;
+    }
     
-    if (showSteps) {
-        printHeader("INSERTION SORT - LINKED LIST");
-        printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-        printList(*head);
+    // Distinct run ids in file order (the file is append-only, so oldest first)
+    const char* runs[MAX_RUNS_LISTED];
+    int numRuns = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool seen = false;
+        for (int r = 0; r < numRuns && !seen; r++) {
+            seen = strcmp(runs[r], records[i].runId) == 0;
+        }
+        if (seen) continue;
+        if (numRuns == MAX_RUNS_LISTED) {
+            memmove(runs, runs + 1, (MAX_RUNS_LISTED - 1) * sizeof(char*));
+            numRuns--;
+        }
+        runs[numRuns++] = records[i].runId;
     }
     
-    Node* sorted = NULL;
-    Node* current = *head;
+    printf("Recorded runs:\n");
+    for (int r = 0; r < numRuns; r++) {
+        size_t runRecords = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (strcmp(records[i].runId, runs[r]) == 0) runRecords++;
+        }
+        printf("%2d. %s (%zu records)\n", r + 1, runs[r], runRecords);
+    }
     
-    while (current != NULL) {
-        Node* next = current->next;
+    int baseline, candidate;
+    printf("Choose baseline run: ");
+    scanf("%d", &baseline);
+    printf("Choose candidate run: ");
+    scanf("%d", &candidate);
+    if (baseline < 1 || baseline > numRuns || candidate < 1 || candidate > numRuns) {
+        printf("Invalid choice!\n");
+        free(records);
+        return;
+    }
+    const char* baseRun = runs[baseline - 1];
+    const char* newRun = runs[candidate - 1];
+    
+    printf("\nBaseline %s vs candidate %s (Welch's t-test, one-sided 95%%)\n\n", baseRun, newRun);
+    printf("%-22s %-12s %-6s %-5s %-8s %-14s %-14s %-10s %s\n",
+           "Algorithm", "Distribution", "Order", "Thr", "Size", "Base (ms)", "New (ms)", "Change", "Verdict");
+    printf("------------------------------------------------------------------------------------------------------------\n");
+    
+    int regressions = 0;
+    for (size_t i = 0; i < count; i++) {
+        const BenchmarkRecord* key = &records[i];
+        if (strcmp(key->runId, baseRun) != 0) continue;
+        
+        // Report each case once, at its first baseline occurrence
+        bool reported = false;
+        for (size_t j = 0; j < i && !reported; j++) {
+            reported = strcmp(records[j].runId, baseRun) == 0 && sameBenchmarkCase(&records[j], key);
+        }
+        if (reported) continue;
         
-        if (sorted == NULL ||
-            (ascending && strcmp(current->info, sorted->info) < 0) ||
-            (!ascending && strcmp(current->info, sorted->info) > 0)) {
-            current->next = sorted;
-            sorted = current;
-            stats->swaps++;
-            stats->comparisons++;
+        unsigned int n1, n2;
+        double mean1, mean2, sd1, sd2;
+        summarizeBenchmarkCase(records, count, baseRun, key, &n1, &mean1, &sd1);
+        summarizeBenchmarkCase(records, count, newRun, key, &n2, &mean2, &sd2);
+        if (n2 == 0) continue;
+        
+        double change = mean1 > 0.0 ? 100.0 * (mean2 - mean1) / mean1 : 0.0;
+        const char* verdict;
+        if (n1 < 2 || n2 < 2) {
+            verdict = "n/a (need 2+ repetitions)";
         } else {
-            Node* temp = sorted;
-            while (temp->next != NULL &&
-                   ((ascending && strcmp(current->info, temp->next->info) > 0) ||
-                    (!ascending && strcmp(current->info, temp->next->info) < 0))) {
-                temp = temp->next;
-                stats->comparisons++;
+            double v1 = sd1 * sd1 / n1, v2 = sd2 * sd2 / n2;
+            double se = sqrt(v1 + v2);
+            double t = se > 0.0 ? (mean2 - mean1) / se : 0.0;
+            double df = (v1 + v2 > 0.0)
+                ? (v1 + v2) * (v1 + v2) / (v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1))
+                : n1 + n2 - 2;
+            if (t > tCritical95(df)) {
+                verdict = "SLOWER";
+                regressions++;
+            } else if (-t > tCritical95(df)) {
+                verdict = "faster";
+            } else {
+                verdict = "no significant change";
             }
-            current->next = temp->next;
-            temp->next = current;
-            stats->swaps++;
-        }
-        current = next;
-        if (showSteps) {
-            printf("Step %llu: ", stats->swaps);
-            printList(sorted);
         }
+        printf("%-22s %-12s %-6s %-5u %-8zu %-14.4f %-14.4f %+8.1f%%  %s\n",
+               key->algorithm, key->distribution, key->order, key->threads, key->size,
+               mean1, mean2, change, verdict);
     }
-    *head = sorted;
     
-    stats->execution_time_ms = getTimeMs() - startTime;
+    printf("\n%d significant slowdown(s) found.\n", regressions);
+    free(records);
 }
 
 // ============================================================================
-// USER INTERFACE FUNCTIONS
+// VERIFICATION
 // ============================================================================
 
-void printMainMenu() {
-    clearScreen();
-    printf("\n=== INTERACTIVE SORTING ALGORITHMS ===\n");
-    printf("1. Array/Vector Sorting\n");
-    printf("2. Matrix/String Array Sorting\n");
-    printf("3. Linked List Sorting\n");
-    printf("4. Performance Testing Mode\n");
-    printf("5. Exit\n");
-    printf("Choose option (1-5): ");
+// Every engine's output must be ordered, a permutation of its input (same
+// multiset hash) and, as the output of a correct int sort is unique, identical
+// to every other engine's (same sequence hash). The typed, batch, container,
+// queue, string and list engines sort keys made from the same inputs. Equal
+// ints cannot be told apart, so stability is checked on (key, payload)
+// records (sortlib_private.h), on list node identity and on
+// sortlib_sortTableRows with a row id column riding along.
+
+sortlib_ThreadPool* verifyPool;              // Pool of the parallel engines under test
+
+uint64_t mixBits(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
 }
 
-void printAlgorithmMenu(const char* dataType) {
-    printf("\nChoose sorting algorithm for %s:\n", dataType);
-    printf("1. Bubble Sort\n");
-    printf("2. Selection Sort\n");
-    printf("3. Insertion Sort\n");
-    printf("4. Merge Sort\n");
-    printf("5. Quick Sort\n");
-    printf("6. Comb Sort\n");
-    printf("Choice: ");
+// SplitMix64: fast enough to fill 10^8 elements, unlike randomBits64
+uint64_t splitMix64(uint64_t* state) {
+    *state += 0x9E3779B97F4A7C15ULL;
+    return mixBits(*state);
 }
 
-void printOrderMenu() {
-    printf("Choose sort order:\n");
-    printf("1. Ascending\n");
-    printf("2. Descending\n");
-    printf("Choice: ");
+// Two independent sums of hashed values; equal for any reordering
+void addToMultisetHash(MultisetHash* hash, uint64_t bits) {
+    hash->sum += mixBits(bits);
+    hash->sumAlternate += mixBits(bits ^ 0x5851F42D4C957F2DULL);
 }
 
-void printVisualizationMenu() {
-    printf("Show step-by-step visualization?\n");
-    printf("1. Yes\n");
-    printf("2. No\n");
-    printf("Choice: ");
+MultisetHash multisetHash(const int* arr, size_t size) {
+    MultisetHash hash = {0, 0};
+    for (size_t i = 0; i < size; i++) {
+        addToMultisetHash(&hash, (uint32_t)arr[i]);
+    }
+    return hash;
 }
 
-// ============================================================================
-// MAIN SORTING FUNCTIONS
-// ============================================================================
+bool sameMultiset(MultisetHash a, MultisetHash b) {
+    return a.sum == b.sum && a.sumAlternate == b.sumAlternate;
+}
 
-void arraySorting() {
-    clearScreen();
-    printHeader("ARRAY SORTING");
-    
-    // Get array size
-    unsigned int size;
-    printf("Enter array size: ");
-    scanf("%u", &size);
-    if (size == 0) {
+uint64_t sequenceHash(const int* arr, size_t size) {
+    uint64_t hash = size;
+    for (size_t i = 0; i < size; i++) {
+        hash = hash * 0x100000001B3ULL + mixBits((uint32_t)arr[i]);
+    }
+    return hash;
+}
+
+// Index of the first element out of order, size if there is none
+size_t firstUnsorted(const int* arr, size_t size, bool ascending) {
+    for (size_t i = 1; i < size; i++) {
+        if (ascending ? arr[i] < arr[i - 1] : arr[i] > arr[i - 1]) return i;
+    }
+    return size;
+}
+
+void generateUniform(int* arr, size_t size, uint64_t* seed) {
+    for (size_t i = 0; i < size; i++) arr[i] = (int)(uint32_t)splitMix64(seed);
+}
+
+void generateFewDistinct(int* arr, size_t size, uint64_t* seed) {
+    for (size_t i = 0; i < size; i++) arr[i] = (int)(splitMix64(seed) % 16);
+}
+
+// The value range of generateRandomArray
+void generateSmallRange(int* arr, size_t size, uint64_t* seed) {
+    for (size_t i = 0; i < size; i++) arr[i] = (int)(splitMix64(seed) % 10000);
+}
+
+void generateAllEqual(int* arr, size_t size, uint64_t* seed) {
+    (void)seed;
+    for (size_t i = 0; i < size; i++) arr[i] = 42;
+}
+
+void generateSorted(int* arr, size_t size, uint64_t* seed) {
+    (void)seed;
+    for (size_t i = 0; i < size; i++) arr[i] = (int)(i - size / 2);
+}
+
+void generateReversed(int* arr, size_t size, uint64_t* seed) {
+    (void)seed;
+    for (size_t i = 0; i < size; i++) arr[i] = (int)(size / 2 - i);
+}
+
+// Sorted with one element in a hundred swapped with a random partner
+void generateNearlySorted(int* arr, size_t size, uint64_t* seed) {
+    generateSorted(arr, size, seed);
+    for (size_t n = size / 100; n > 0; n--) {
+        size_t i = splitMix64(seed) % size, j = splitMix64(seed) % size;
+        int temp = arr[i]; arr[i] = arr[j]; arr[j] = temp;
+    }
+}
+
+void generateOrganPipe(int* arr, size_t size, uint64_t* seed) {
+    (void)seed;
+    for (size_t i = 0; i < size; i++) arr[i] = (int)(i < size / 2 ? i : size - i);
+}
+
+void generateSawtooth(int* arr, size_t size, uint64_t* seed) {
+    (void)seed;
+    for (size_t i = 0; i < size; i++) arr[i] = (int)(i % 1000);
+}
+
+// Musser's median-of-3 killer sequence
+void generateMedianKiller(int* arr, size_t size, uint64_t* seed) {
+    (void)seed;
+    size_t k = size / 2;
+    for (size_t i = 1; i <= k; i++) {
+        if (i % 2) {
+            arr[i - 1] = (int)i;
+            arr[i] = (int)(k + i);
+        }
+        arr[k + i - 1] = (int)(2 * i);
+    }
+    if (size % 2) arr[size - 1] = (int)size;
+}
+
+// Only INT_MIN, INT_MAX, -1, 0 and 1: sign handling and range overflow
+void generateExtremes(int* arr, size_t size, uint64_t* seed) {
+    const int values[] = {INT_MIN, INT_MAX, -1, 0, 1};
+    for (size_t i = 0; i < size; i++) arr[i] = values[splitMix64(seed) % 5];
+}
+
+const VerifyDistribution verifyDistributions[] = {
+    {"random", generateUniform},
+    {"few-distinct", generateFewDistinct},
+    {"small-range", generateSmallRange},
+    {"all-equal", generateAllEqual},
+    {"sorted", generateSorted},
+    {"reversed", generateReversed},
+    {"nearly-sorted", generateNearlySorted},
+    {"organ-pipe", generateOrganPipe},
+    {"sawtooth", generateSawtooth},
+    {"median3-killer", generateMedianKiller},
+    {"extremes", generateExtremes},
+};
+
+// Adapters to the sortlib_ArraySortFunction signature
+void verifyThreeWayQuickSort(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                             const sortlib_Observer* observer) {
+    (void)observer;
+    sortlib_threeWayQuickSort(arr, size, ascending, stats);
+}
+
+void verifyPartialSort(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                       const sortlib_Observer* observer) {
+    (void)observer;
+    sortlib_partialSortInts(arr, size, size, ascending, stats);
+}
+
+void verifyBlockMergeNoScratch(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                               const sortlib_Observer* observer) {
+    sortlib_blockMergeSortArrayWithBuffer(arr, size, 0, ascending, stats, observer);
+}
+
+void verifySampleSort(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                      const sortlib_Observer* observer) {
+    (void)observer;
+    sortlib_parallelSampleSortArray(arr, size, ascending, stats, verifyPool);
+}
+
+void verifyRadixSort(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                     const sortlib_Observer* observer) {
+    (void)observer;
+    sortlib_parallelRadixSortArray(arr, size, ascending, stats, verifyPool);
+}
+
+void verifyCountingSort(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                        const sortlib_Observer* observer) {
+    (void)observer;
+    sortlib_parallelCountingSortArray(arr, size, ascending, stats, verifyPool);
+}
+
+void verifySortIntsWithScratch(int* arr, size_t size, bool ascending, sortlib_Stats* stats, size_t scratchBytes) {
+    void* scratch = scratchBytes > 0 ? malloc(scratchBytes) : NULL;
+    if (scratchBytes > 0 && !scratch) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    sortlib_sortIntsWithStats(arr, size, ascending, scratch, scratchBytes, stats);
+    free(scratch);
+}
+
+void verifySortIntsFull(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                        const sortlib_Observer* observer) {
+    (void)observer;
+    verifySortIntsWithScratch(arr, size, ascending, stats, sortlib_sortScratchBytes(size));
+}
+
+void verifySortIntsSquareRoot(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                              const sortlib_Observer* observer) {
+    (void)observer;
+    verifySortIntsWithScratch(arr, size, ascending, stats, sortlib_blockMergeBufferLength(size) * sizeof(int));
+}
+
+void verifySortIntsNoScratch(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                             const sortlib_Observer* observer) {
+    (void)observer;
+    verifySortIntsWithScratch(arr, size, ascending, stats, 0);
+}
+
+void verifyParallelSortInts(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                            const sortlib_Observer* observer) {
+    (void)observer;
+    size_t scratchBytes = sortlib_parallelSortScratchBytes(size);
+    void* scratch = malloc(scratchBytes);
+    if (!scratch) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    sortlib_parallelSortInts(arr, size, ascending, scratch, scratchBytes, verifyPool, stats);
+    free(scratch);
+}
+
+#define VERIFY_TYPED_INT32(NAME, ENGINE)                                                            \
+void verify##NAME##Int32(int* arr, size_t size, bool ascending, sortlib_Stats* stats,               \
+                         const sortlib_Observer* observer) {                                        \
+    (void)observer;                                                                                 \
+    sortlib_##ENGINE##Int32((int32_t*)arr, size, ascending, stats);                                 \
+}
+
+VERIFY_TYPED_INT32(InsertionSort, insertionSort)
+VERIFY_TYPED_INT32(MergeSort, mergeSort)
+VERIFY_TYPED_INT32(QuickSort, quickSort)
+VERIFY_TYPED_INT32(HeapSort, heapSort)
+VERIFY_TYPED_INT32(RadixSort, radixSort)
+
+const VerifyEngine verifyEngines[] = {
+    {"Bubble Sort", sortlib_bubbleSortArray, VERIFY_QUADRATIC, false},
+    {"Selection Sort", sortlib_selectionSortArray, VERIFY_QUADRATIC, false},
+    {"Insertion Sort", sortlib_insertionSortArray, VERIFY_QUADRATIC, false},
+    {"Merge Sort", sortlib_mergeSortArray, VERIFY_LINEARITHMIC, false},
+    {"Quick Sort", sortlib_quickSortArray, VERIFY_LINEARITHMIC, false},
+    {"Comb Sort", sortlib_combSortArray, VERIFY_LINEARITHMIC, false},
+    {"Heap Sort", sortlib_heapSortArray, VERIFY_LINEARITHMIC, false},
+    // Wide ranges fall back to quick sort (Auto: radix sort)
+    {"Counting Sort", sortlib_countingSortArray, VERIFY_LINEARITHMIC, false},
+    {"Auto", sortlib_autoSortArray, VERIFY_LINEARITHMIC, false},
+    {"Block Merge", sortlib_blockMergeSortArray, VERIFY_LINEARITHMIC, false},
+    {"Block Merge [no scratch]", verifyBlockMergeNoScratch, VERIFY_LINEARITHMIC, false},
+    {"Three-Way Quick Sort", verifyThreeWayQuickSort, VERIFY_LINEARITHMIC, false},
+    {"Partial Sort [k = n]", verifyPartialSort, VERIFY_LINEARITHMIC, false},
+    {"Sample Sort [pool]", verifySampleSort, VERIFY_LINEARITHMIC, true},
+    {"Radix Sort [pool]", verifyRadixSort, VERIFY_LINEARITHMIC, true},
+    // Falls back to sample sort when counting does not win
+    {"Counting Sort [pool]", verifyCountingSort, VERIFY_LINEARITHMIC, true},
+    {"sortlib_sortInts [full scratch]", verifySortIntsFull, VERIFY_LINEARITHMIC, false},
+    {"sortlib_sortInts [sqrt scratch]", verifySortIntsSquareRoot, VERIFY_LINEARITHMIC, false},
+    {"sortlib_sortInts [no scratch]", verifySortIntsNoScratch, VERIFY_LINEARITHMIC, false},
+    {"sortlib_parallelSortInts", verifyParallelSortInts, VERIFY_LINEARITHMIC, true},
+    {"Insertion Sort [int32]", verifyInsertionSortInt32, VERIFY_QUADRATIC, false},
+    {"Merge Sort [int32]", verifyMergeSortInt32, VERIFY_LINEARITHMIC, false},
+    {"Quick Sort [int32]", verifyQuickSortInt32, VERIFY_LINEARITHMIC, false},
+    {"Heap Sort [int32]", verifyHeapSortInt32, VERIFY_LINEARITHMIC, false},
+    {"Radix Sort [int32]", verifyRadixSortInt32, VERIFY_LINEARITHMIC, false},
+};
+
+#define NUM_VERIFY_DISTRIBUTIONS (sizeof(verifyDistributions) / sizeof(verifyDistributions[0]))
+#define NUM_VERIFY_ENGINES (sizeof(verifyEngines) / sizeof(verifyEngines[0]))
+
+// Sorts (key, row id) rows by the key alone; rows with equal keys must keep
+// their ids increasing. Returns false and explains why on failure.
+bool verifyTableStability(const int* values, size_t size, bool ascending, char* failure, size_t length) {
+    sortlib_IntMatrix table = {malloc(size * 2 * sizeof(int)), size, 2};
+    if (!table.data) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t r = 0; r < size; r++) {
+        table.data[2 * r] = values[r];
+        table.data[2 * r + 1] = (int)r;
+    }
+    
+    sortlib_Key key = {0, ascending};
+    sortlib_Stats stats;
+    bool ok = sortlib_sortTableRows(&table, &key, 1, &stats);
+    if (!ok) snprintf(failure, length, "TABLE REJECTED");
+    
+    char* seen = calloc(size, 1);
+    if (!seen) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t r = 0; r < size && ok; r++) {
+        int value = table.data[2 * r], id = table.data[2 * r + 1];
+        if (id < 0 || (size_t)id >= size || seen[id] || values[id] != value) {
+            snprintf(failure, length, "NOT A PERMUTATION at row %zu", r);
+            ok = false;
+        } else if (r > 0) {
+            int previous = table.data[2 * (r - 1)];
+            if (ascending ? value < previous : value > previous) {
+                snprintf(failure, length, "NOT SORTED at row %zu", r);
+                ok = false;
+            } else if (value == previous && id < table.data[2 * (r - 1) + 1]) {
+                snprintf(failure, length, "NOT STABLE at row %zu", r);
+                ok = false;
+            }
+        }
+        if (ok) seen[id] = 1;
+    }
+    
+    free(seen);
+    free(table.data);
+    return ok;
+}
+
+// Prints a check's row when the case reports every check or the check
+// failed; elapsed is negative for checks whose time means nothing
+void reportCheck(VerifyCase* vc, const char* engine, double elapsed, const char* failure) {
+    if (failure[0]) {
+        vc->failed++;
+    } else {
+        vc->passed++;
+    }
+    if (!vc->report && !failure[0]) return;
+    
+    if (elapsed < 0.0) {
+        printf("%-16s %-12zu %-40s %-15s %-12s %s\n", vc->distribution, vc->size, engine, "-", "-",
+               failure[0] ? failure : "OK");
+        return;
+    }
+    double seconds = elapsed / 1000.0;
+    printf("%-16s %-12zu %-40s %-15.3f %-12.2f %s\n", vc->distribution, vc->size, engine, elapsed,
+           seconds > 0.0 ? vc->size / seconds / 1e6 : 0.0, failure[0] ? failure : "OK");
+}
+
+// Checks above their size cap do not run; the engine was verified at the
+// smaller sizes, so skips do not count against the verdict
+void skipCheck(VerifyCase* vc, const char* engine, const char* reason) {
+    vc->skipped++;
+    if (vc->report) {
+        printf("%-16s %-12zu %-40s SKIPPED: %s\n", vc->distribution, vc->size, engine, reason);
+    }
+}
+
+// Ordered, a permutation of the input and equal to the reference output; the
+// first output that passes becomes the reference (engine must be a literal)
+bool checkIntOutput(VerifyCase* vc, const char* engine, const int* arr, char* failure, size_t length) {
+    size_t unsorted = firstUnsorted(arr, vc->size, vc->ascending);
+    if (unsorted < vc->size) {
+        snprintf(failure, length, "NOT SORTED at index %zu", unsorted);
+        return false;
+    }
+    if (!sameMultiset(multisetHash(arr, vc->size), vc->inputHash)) {
+        snprintf(failure, length, "NOT A PERMUTATION of the input");
+        return false;
+    }
+    uint64_t sequence = sequenceHash(arr, vc->size);
+    if (vc->reference == NULL) {
+        vc->reference = engine;
+        vc->referenceHash = sequence;
+    } else if (sequence != vc->referenceHash) {
+        snprintf(failure, length, "DIFFERS FROM %s", vc->reference);
+        return false;
+    }
+    return true;
+}
+
+// Typed keys keep the distribution's order and ties. For the floating-point
+// types INT_MIN, INT_MAX and -1 become -inf, +inf and NaN, and every other 0
+// becomes -0.0, so the extremes distribution is full of them.
+int64_t verifyKeyInt64(int value, size_t index) {
+    (void)index;
+    return (int64_t)value * 4294967296LL + (value & 0xFFFF);
+}
+
+uint32_t verifyKeyUInt32(int value, size_t index) {
+    (void)index;
+    return (uint32_t)value ^ 0x80000000u;
+}
+
+uint64_t verifyKeyUInt64(int value, size_t index) {
+    (void)index;
+    return ((uint64_t)((uint32_t)value ^ 0x80000000u) << 32) | (uint32_t)value;
+}
+
+double verifyKeyDouble(int value, size_t index) {
+    if (value == INT_MIN) return -INFINITY;
+    if (value == INT_MAX) return INFINITY;
+    if (value == -1) return NAN;
+    if (value == 0) return (index & 1) ? -0.0 : 0.0;
+    return value / 8.0;
+}
+
+float verifyKeyFloat(int value, size_t index) {
+    return (float)verifyKeyDouble(value, index);
+}
+
+#define NEVER_NAN(value) false
+
+// verifyTyped##NAME runs the typed engines on keys made from the case's
+// values. Outputs must be ordered with the NaNs last (in both orders) and a
+// permutation of the input's bit patterns; -0.0 and 0.0 may come in any order.
+#define VERIFY_TYPED_ENGINES(TYPE, NAME, LABEL, IS_NAN)                                             \
+size_t firstUnsorted##NAME(const TYPE* keys, size_t size, bool ascending) {                         \
+    for (size_t i = 1; i < size; i++) {                                                             \
+        TYPE previous = keys[i - 1], current = keys[i];                                             \
+        if (IS_NAN(current)) continue;                                                              \
+        if (IS_NAN(previous) || (ascending ? current < previous : current > previous)) return i;    \
+    }                                                                                               \
+    return size;                                                                                    \
+}                                                                                                   \
+                                                                                                    \
+MultisetHash multisetHash##NAME(const TYPE* keys, size_t size) {                                    \
+    MultisetHash hash = {0, 0};                                                                     \
+    for (size_t i = 0; i < size; i++) {                                                             \
+        uint64_t bits = 0;                                                                          \
+        memcpy(&bits, &keys[i], sizeof(TYPE));                                                      \
+        addToMultisetHash(&hash, bits);                                                             \
+    }                                                                                               \
+    return hash;                                                                                    \
+}                                                                                                   \
+                                                                                                    \
+void verifyTyped##NAME(VerifyCase* vc, TYPE* keys) {                                                \
+    const char* names[] = {"Insertion Sort", "Merge Sort", "Quick Sort", "Heap Sort", "Radix Sort"}; \
+    void (*sorts[])(TYPE*, size_t, bool, sortlib_Stats*) = {                                        \
+        sortlib_insertionSort##NAME, sortlib_mergeSort##NAME, sortlib_quickSort##NAME,              \
+        sortlib_heapSort##NAME, sortlib_radixSort##NAME                                             \
+    };                                                                                              \
+    for (size_t i = 0; i < vc->size; i++) keys[i] = verifyKey##NAME(vc->values[i], i);              \
+    MultisetHash inputHash = multisetHash##NAME(keys, vc->size);                                    \
+                                                                                                    \
+    for (int e = 0; e < 5; e++) {                                                                   \
+        char engine[MAX_FIELD_LENGTH];                                                              \
+        snprintf(engine, sizeof(engine), "%s [%s]", names[e], LABEL);                               \
+        if (e == 0 && vc->size > VERIFY_QUADRATIC_LIMIT) {                                          \
+            skipCheck(vc, engine, "quadratic");                                                     \
+            continue;                                                                               \
+        }                                                                                           \
+        for (size_t i = 0; i < vc->size; i++) keys[i] = verifyKey##NAME(vc->values[i], i);          \
+                                                                                                    \
+        sortlib_Stats stats;                                                                        \
+        double startTime = sortlib_timeMs();                                                        \
+        sorts[e](keys, vc->size, vc->ascending, &stats);                                            \
+        double elapsed = sortlib_timeMs() - startTime;                                              \
+                                                                                                    \
+        char failure[MAX_FIELD_LENGTH] = "";                                                        \
+        size_t unsorted = firstUnsorted##NAME(keys, vc->size, vc->ascending);                       \
+        if (unsorted < vc->size) {                                                                  \
+            snprintf(failure, sizeof(failure), "NOT SORTED at index %zu", unsorted);                \
+        } else if (!sameMultiset(multisetHash##NAME(keys, vc->size), inputHash)) {                  \
+            snprintf(failure, sizeof(failure), "NOT A PERMUTATION of the input");                   \
+        }                                                                                           \
+        reportCheck(vc, engine, elapsed, failure);                                                  \
+    }                                                                                               \
+}
+
+VERIFY_TYPED_ENGINES(int64_t, Int64, "int64", NEVER_NAN)
+VERIFY_TYPED_ENGINES(uint32_t, UInt32, "uint32", NEVER_NAN)
+VERIFY_TYPED_ENGINES(uint64_t, UInt64, "uint64", NEVER_NAN)
+VERIFY_TYPED_ENGINES(float, Float, "float", isnan)
+VERIFY_TYPED_ENGINES(double, Double, "double", isnan)
+
+// Splits size elements into arrays of 0 to SORTLIB_MAX_NETWORK_WIDTH + 7
+// elements: empty and single arrays, every network width and the quick sort
+// fallback. Fills offsets (count + 1 entries) unless it is NULL; returns count.
+size_t batchOffsets(size_t size, size_t* offsets) {
+    size_t count = 0, offset = 0;
+    while (offset < size) {
+        size_t length = (count * 7) % (SORTLIB_MAX_NETWORK_WIDTH + 8);
+        if (length > size - offset) length = size - offset;
+        if (offsets) offsets[count] = offset;
+        offset += length;
+        count++;
+    }
+    if (offsets) offsets[count] = size;
+    return count;
+}
+
+// Every array of the batch must be ordered and a permutation of its input
+void verifyBatchSorts(VerifyCase* vc, int* work) {
+    size_t count = batchOffsets(vc->size, NULL);
+    size_t* offsets = malloc((count + 1) * sizeof(size_t));
+    if (!offsets) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    batchOffsets(vc->size, offsets);
+    
+    const char* names[] = {"Batch [networks]", "Batch [interleaved]", "Batch [networks, pool]",
+                           "Batch [interleaved, pool]"};
+    for (int variant = 0; variant < 4; variant++) {
+        bool interleave = (variant & 1) != 0;
+        sortlib_ThreadPool* pool = variant >= 2 ? verifyPool : NULL;
+        memcpy(work, vc->values, vc->size * sizeof(int));
+        
+        sortlib_Stats stats;
+        double startTime = sortlib_timeMs();
+        sortlib_sortArrayBatch(work, offsets, count, vc->ascending, interleave, &stats, pool);
+        double elapsed = sortlib_timeMs() - startTime;
+        
+        char failure[MAX_FIELD_LENGTH] = "";
+        for (size_t a = 0; a < count && !failure[0]; a++) {
+            size_t length = offsets[a + 1] - offsets[a];
+            const int* arr = work + offsets[a];
+            if (firstUnsorted(arr, length, vc->ascending) < length) {
+                snprintf(failure, sizeof(failure), "NOT SORTED: array %zu", a);
+            } else if (!sameMultiset(multisetHash(arr, length), multisetHash(vc->values + offsets[a], length))) {
+                snprintf(failure, sizeof(failure), "NOT A PERMUTATION: array %zu", a);
+            }
+        }
+        reportCheck(vc, names[variant], elapsed, failure);
+    }
+    free(offsets);
+}
+
+// Inserts the values one by one; the contents must equal the reference sort.
+// Every flush of the sorted container merges into the whole base, so it is
+// quadratic in the number of batches.
+void verifyContainers(VerifyCase* vc, int* work) {
+    char failure[MAX_FIELD_LENGTH] = "";
+    if (vc->size > VERIFY_QUADRATIC_LIMIT) {
+        skipCheck(vc, "Sorted Container", "quadratic");
+    } else {
+        sortlib_SortedContainer sorted;
+        double startTime = sortlib_timeMs();
+        bool ok = sortlib_initSortedContainer(&sorted, VERIFY_BATCH_CAPACITY, vc->ascending);
+        for (size_t i = 0; i < vc->size && ok; i++) {
+            ok = sortlib_insertSortedContainer(&sorted, vc->values[i]);
+        }
+        ok = ok && sortlib_flushSortedContainer(&sorted);
+        double elapsed = sortlib_timeMs() - startTime;
+        
+        if (!ok) {
+            snprintf(failure, sizeof(failure), "OUT OF MEMORY");
+        } else if (sorted.size != vc->size) {
+            snprintf(failure, sizeof(failure), "HOLDS %zu ELEMENTS", sorted.size);
+        } else {
+            checkIntOutput(vc, "Sorted Container", sorted.base, failure, sizeof(failure));
+        }
+        reportCheck(vc, "Sorted Container", elapsed, failure);
+        sortlib_freeSortedContainer(&sorted);
+    }
+    
+    failure[0] = '\0';
+    sortlib_TieredContainer tiered;
+    double startTime = sortlib_timeMs();
+    bool ok = sortlib_initTieredContainer(&tiered, VERIFY_BATCH_CAPACITY, vc->ascending);
+    for (size_t i = 0; i < vc->size && ok; i++) {
+        ok = sortlib_insertTieredContainer(&tiered, vc->values[i]);
+    }
+    size_t held = sortlib_tieredContainerSize(&tiered);
+    ok = ok && (held != vc->size || sortlib_materializeTieredContainer(&tiered, work));
+    double elapsed = sortlib_timeMs() - startTime;
+    
+    if (!ok) {
+        snprintf(failure, sizeof(failure), "OUT OF MEMORY");
+    } else if (held != vc->size) {
+        snprintf(failure, sizeof(failure), "HOLDS %zu ELEMENTS", held);
+    } else {
+        checkIntOutput(vc, "Tiered Container", work, failure, sizeof(failure));
+    }
+    reportCheck(vc, "Tiered Container", elapsed, failure);
+    sortlib_freeTieredContainer(&tiered);
+}
+
+// Pushes every value with its index as payload and pops them all: the keys
+// must come out in order and each payload once, with its own key
+void verifyPriorityQueues(VerifyCase* vc, int* work) {
+    char* seen = malloc(vc->size ? vc->size : 1);
+    if (!seen) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    
+    const unsigned int arities[] = {2, SORTLIB_HEAP_ARITY};
+    for (int a = 0; a < 2; a++) {
+        char engine[MAX_FIELD_LENGTH];
+        char failure[MAX_FIELD_LENGTH] = "";
+        snprintf(engine, sizeof(engine), "Priority Queue [%u-ary]", arities[a]);
+        memset(seen, 0, vc->size);
+        
+        double startTime = sortlib_timeMs();
+        sortlib_PriorityQueue* pq = sortlib_createPriorityQueue(arities[a], vc->ascending, 0);
+        bool ok = pq != NULL;
+        for (size_t i = 0; i < vc->size && ok; i++) {
+            ok = sortlib_pushPriorityQueue(pq, vc->values[i], i);
+        }
+        size_t popped = 0;
+        sortlib_HeapEntry entry;
+        while (ok && !failure[0] && sortlib_popPriorityQueue(pq, &entry)) {
+            if (popped == vc->size) {
+                snprintf(failure, sizeof(failure), "POPPED MORE THAN %zu", vc->size);
+            } else if (entry.payload >= vc->size || seen[entry.payload] || vc->values[entry.payload] != entry.key) {
+                snprintf(failure, sizeof(failure), "WRONG PAYLOAD at pop %zu", popped);
+            } else {
+                seen[entry.payload] = 1;
+                work[popped++] = entry.key;
+            }
+        }
+        double elapsed = sortlib_timeMs() - startTime;
+        
+        if (!ok) {
+            snprintf(failure, sizeof(failure), "OUT OF MEMORY");
+        } else if (!failure[0] && popped != vc->size) {
+            snprintf(failure, sizeof(failure), "POPPED %zu OF %zu", popped, vc->size);
+        } else if (!failure[0]) {
+            checkIntOutput(vc, "Priority Queue", work, failure, sizeof(failure));
+        }
+        reportCheck(vc, engine, elapsed, failure);
+        if (pq) sortlib_freePriorityQueue(pq);
+    }
+    free(seen);
+}
+
+// Seven base-26 letters, most significant first, so byte order follows the
+// int order and small ranges share long prefixes. The value picks which
+// letters are upper case (equal ints stay equal strings), so byte order,
+// locale order and case folding disagree.
+void formatVerifyString(int value, char* out) {
+    uint32_t key = (uint32_t)value ^ 0x80000000u;
+    uint64_t upper = mixBits(key);
+    for (int i = VERIFY_STRING_WIDTH - 2; i >= 0; i--) {
+        out[i] = (char)((upper >> i & 1 ? 'A' : 'a') + key % 26);
+        key /= 26;
+    }
+    out[VERIFY_STRING_WIDTH - 1] = '\0';
+}
+
+int compareStringsAscending(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+int compareStringsDescending(const void* a, const void* b) {
+    return strcmp(*(char* const*)b, *(char* const*)a);
+}
+
+// Rows pointing into a fresh copy of the case's strings
+void resetStringRows(char** rows, char* text, const char* strings, size_t size) {
+    memcpy(text, strings, size * VERIFY_STRING_WIDTH);
+    for (size_t i = 0; i < size; i++) rows[i] = text + i * VERIFY_STRING_WIDTH;
+}
+
+// Collation order: consecutive strings ordered by their collation keys
+size_t firstUncollated(char* const* rows, size_t size, sortlib_CollationMode mode, bool ascending) {
+    char previous[4 * SORTLIB_STRING_LENGTH], current[4 * SORTLIB_STRING_LENGTH];
+    if (size > 0) sortlib_collationKey(rows[0], mode, previous, sizeof(previous));
+    for (size_t i = 1; i < size; i++) {
+        sortlib_collationKey(rows[i], mode, current, sizeof(current));
+        int order = strcmp(previous, current);
+        if (ascending ? order > 0 : order < 0) return i;
+        memcpy(previous, current, sizeof(current));
+    }
+    return size;
+}
+
+// Byte order must give exactly the rows of a qsort of the input; the
+// collation orders leave ties in no particular order, so their rows must be
+// ordered by collation key and, sorted again by qsort, equal the reference
+void verifyStringSorts(VerifyCase* vc, const char* strings) {
+    size_t size = vc->size;
+    char* text = malloc(size * VERIFY_STRING_WIDTH + 1);
+    char** rows = malloc((size ? size : 1) * sizeof(char*));
+    char** reference = malloc((size ? size : 1) * sizeof(char*));
+    char* referenceText = malloc(size * VERIFY_STRING_WIDTH + 1);
+    if (!text || !rows || !reference || !referenceText) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    int (*compare)(const void*, const void*) = vc->ascending ? compareStringsAscending : compareStringsDescending;
+    resetStringRows(reference, referenceText, strings, size);
+    qsort(reference, size, sizeof(char*), compare);
+    
+    const char* names[] = {"Bubble Sort [matrix]", "Parallel String Sort [pool]", "Collation Sort [locale, pool]",
+                           "Collation Sort [case fold, pool]"};
+    for (int e = 0; e < 4; e++) {
+        if (e == 0 && size > VERIFY_QUADRATIC_LIMIT) {
+            skipCheck(vc, names[e], "quadratic");
+            continue;
+        }
+        resetStringRows(rows, text, strings, size);
+        sortlib_CollationMode mode = e == 2 ? SORTLIB_COLLATION_LOCALE : SORTLIB_COLLATION_CASE_FOLD;
+        
+        sortlib_Stats stats;
+        bool ok = true;
+        double startTime = sortlib_timeMs();
+        if (e == 0) {
+            sortlib_bubbleSortMatrix(rows, (unsigned int)size, vc->ascending, &stats, NULL);
+        } else if (e == 1) {
+            sortlib_parallelStringSortMatrix(rows, size, vc->ascending, &stats, verifyPool, NULL);
+        } else {
+            ok = sortlib_collationSortMatrix(rows, size, mode, vc->ascending, &stats, verifyPool, NULL);
+        }
+        double elapsed = sortlib_timeMs() - startTime;
+        
+        char failure[MAX_FIELD_LENGTH] = "";
+        if (!ok) {
+            snprintf(failure, sizeof(failure), "OUT OF MEMORY");
+        } else if (e >= 2) {
+            size_t unsorted = firstUncollated(rows, size, mode, vc->ascending);
+            if (unsorted < size) {
+                snprintf(failure, sizeof(failure), "NOT COLLATED at row %zu", unsorted);
+            } else {
+                qsort(rows, size, sizeof(char*), compare);
+            }
+        }
+        for (size_t i = 0; i < size && !failure[0]; i++) {
+            if (strcmp(rows[i], reference[i]) != 0) {
+                snprintf(failure, sizeof(failure), e >= 2 ? "NOT A PERMUTATION (row %zu)" : "DIFFERS FROM qsort at row %zu",
+                         i);
+            }
+        }
+        reportCheck(vc, names[e], elapsed, failure);
+    }
+    
+    free(referenceText);
+    free(reference);
+    free(rows);
+    free(text);
+}
+
+// Nodes compare by string, then by address: the nodes are one array in input
+// order, so this is the stable order
+int compareNodesAscending(const void* a, const void* b) {
+    const sortlib_Node* x = *(const sortlib_Node* const*)a;
+    const sortlib_Node* y = *(const sortlib_Node* const*)b;
+    int order = strcmp(x->info, y->info);
+    return order ? order : (x > y) - (x < y);
+}
+
+int compareNodesDescending(const void* a, const void* b) {
+    const sortlib_Node* x = *(const sortlib_Node* const*)a;
+    const sortlib_Node* y = *(const sortlib_Node* const*)b;
+    int order = strcmp(y->info, x->info);
+    return order ? order : (x > y) - (x < y);
+}
+
+sortlib_Node* linkNodes(sortlib_Node* nodes, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        nodes[i].next = (i + 1 < size) ? &nodes[i + 1] : NULL;
+    }
+    return size ? nodes : NULL;
+}
+
+// The list sorts relink nodes, so node identity shows stability: bubble and
+// insertion sort must give exactly the stable qsort order. The collation
+// sorts promise no order for ties: every node once, ordered by key.
+void verifyListSorts(VerifyCase* vc, const char* strings) {
+    size_t size = vc->size;
+    sortlib_Node* nodes = malloc((size ? size : 1) * sizeof(sortlib_Node));
+    sortlib_Node** reference = malloc((size ? size : 1) * sizeof(sortlib_Node*));
+    char** rows = malloc((size ? size : 1) * sizeof(char*));
+    char* seen = malloc(size ? size : 1);
+    if (!nodes || !reference || !rows || !seen) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < size; i++) {
+        memcpy(nodes[i].info, strings + i * VERIFY_STRING_WIDTH, VERIFY_STRING_WIDTH);
+        reference[i] = &nodes[i];
+    }
+    qsort(reference, size, sizeof(sortlib_Node*), vc->ascending ? compareNodesAscending : compareNodesDescending);
+    
+    const char* names[] = {"Bubble Sort [list]", "Insertion Sort [list]", "Collation Sort [locale, list]",
+                           "Collation Sort [case fold, list]"};
+    for (int e = 0; e < 4; e++) {
+        if (e < 2 && size > VERIFY_QUADRATIC_LIMIT) {
+            skipCheck(vc, names[e], "quadratic");
+            continue;
+        }
+        sortlib_Node* head = linkNodes(nodes, size);
+        sortlib_CollationMode mode = e == 2 ? SORTLIB_COLLATION_LOCALE : SORTLIB_COLLATION_CASE_FOLD;
+        
+        sortlib_Stats stats;
+        bool ok = true;
+        double startTime = sortlib_timeMs();
+        if (e == 0) {
+            sortlib_bubbleSortList(&head, vc->ascending, &stats, NULL);
+        } else if (e == 1) {
+            sortlib_insertionSortList(&head, vc->ascending, &stats, NULL);
+        } else {
+            ok = sortlib_collationSortList(&head, mode, vc->ascending, &stats, NULL);
+        }
+        double elapsed = sortlib_timeMs() - startTime;
+        
+        char failure[MAX_FIELD_LENGTH] = "";
+        memset(seen, 0, size);
+        size_t count = 0;
+        for (sortlib_Node* node = head; node != NULL && !failure[0]; node = node->next, count++) {
+            size_t index = (size_t)(node - nodes);
+            if (count == size || index >= size || seen[index]) {
+                snprintf(failure, sizeof(failure), "NOT A PERMUTATION at node %zu", count);
+                break;
+            }
+            seen[index] = 1;
+            rows[count] = node->info;
+            if (e < 2 && node != reference[count]) {
+                snprintf(failure, sizeof(failure), strcmp(node->info, reference[count]->info) == 0
+                         ? "NOT STABLE at node %zu" : "DIFFERS FROM qsort at node %zu", count);
+            }
+        }
+        if (!ok) {
+            snprintf(failure, sizeof(failure), "OUT OF MEMORY");
+        } else if (!failure[0] && count != size) {
+            snprintf(failure, sizeof(failure), "LOST NODES: %zu of %zu", count, size);
+        } else if (!failure[0] && e >= 2) {
+            size_t unsorted = firstUncollated(rows, size, mode, vc->ascending);
+            if (unsorted < size) snprintf(failure, sizeof(failure), "NOT COLLATED at node %zu", unsorted);
+        }
+        reportCheck(vc, names[e], elapsed, failure);
+    }
+    
+    free(seen);
+    free(rows);
+    free(reference);
+    free(nodes);
+}
+
+// Records for the stability probes: the key is the value's low 16 bits, sign
+// extended, and the payload counts the key's earlier occurrences. The stable
+// order is then known without sorting: keys ascending, payloads 0, 1, 2, ...
+void generateRecords(const int* values, size_t size, int* records, size_t* keyCounts) {
+    memset(keyCounts, 0, 65536 * sizeof(size_t));
+    for (size_t i = 0; i < size; i++) {
+        int key = (int)(((uint32_t)values[i] & 0xFFFF) ^ 0x8000) - 0x8000;
+        records[i] = SORTLIB_RECORD(key, keyCounts[key + 32768]++ & 0xFFFF);
+    }
+}
+
+// First record that differs from the stable order; fills failure
+bool checkStableRecords(const int* records, const size_t* keyCounts, char* failure, size_t length) {
+    size_t i = 0;
+    for (int key = -32768; key < 32768; key++) {
+        for (size_t n = 0; n < keyCounts[key + 32768]; n++, i++) {
+            if (records[i] == SORTLIB_RECORD(key, n & 0xFFFF)) continue;
+            snprintf(failure, length, SORTLIB_RECORD_KEY(records[i]) == key ? "NOT STABLE at index %zu"
+                     : "NOT SORTED at index %zu", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Merge Sort, Block Merge at buffer lengths 0, 1, 4, 16, ..., the square root
+// and size / 2, and sortlib_sortInts's sorts with full and square-root scratch,
+// all on (key, payload) records; then the keyed table sort
+void verifyStability(VerifyCase* vc, int* work) {
+    const char* names[] = {"Merge Sort [stable]", "Block Merge [stable, every buffer]",
+                           "sortlib_sortInts [stable, full scratch]", "sortlib_sortInts [stable, sqrt scratch]",
+                           "Table Sort [stable]"};
+    if (vc->size > VERIFY_STABILITY_LIMIT) {
+        for (int e = 0; e < 5; e++) skipCheck(vc, names[e], "stability limit");
+        return;
+    }
+    
+    size_t size = vc->size;
+    size_t* keyCounts = malloc(65536 * sizeof(size_t));
+    size_t fullBytes = sortlib_sortScratchBytes(size);
+    void* scratch = malloc(fullBytes ? fullBytes : 1);
+    if (!keyCounts || !scratch) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    
+    for (int e = 0; e < 4; e++) {
+        char failure[MAX_FIELD_LENGTH] = "";
+        sortlib_Stats stats;
+        double startTime = sortlib_timeMs();
+        if (e == 0) {
+            generateRecords(vc->values, size, work, keyCounts);
+            sortlib_mergeSortRecords(work, size, &stats);
+            checkStableRecords(work, keyCounts, failure, sizeof(failure));
+        } else if (e == 1) {
+            size_t lengths[40];
+            size_t numLengths = 0;
+            lengths[numLengths++] = 0;
+            for (size_t length = 1; length < size / 2; length *= 4) lengths[numLengths++] = length;
+            lengths[numLengths++] = sortlib_blockMergeBufferLength(size);
+            lengths[numLengths++] = size / 2;
+            for (size_t b = 0; b < numLengths && !failure[0]; b++) {
+                generateRecords(vc->values, size, work, keyCounts);
+                sortlib_blockMergeSortRecords(work, size, lengths[b], &stats);
+                if (!checkStableRecords(work, keyCounts, failure, sizeof(failure))) {
+                    size_t used = strlen(failure);
+                    snprintf(failure + used, sizeof(failure) - used, " (buffer %zu)", lengths[b]);
+                }
+            }
+        } else {
+            size_t bytes = e == 2 ? fullBytes : sortlib_blockMergeBufferLength(size) * sizeof(int);
+            generateRecords(vc->values, size, work, keyCounts);
+            sortlib_scratchSortRecords(work, size, scratch, bytes, &stats);
+            checkStableRecords(work, keyCounts, failure, sizeof(failure));
+        }
+        double elapsed = sortlib_timeMs() - startTime;
+        reportCheck(vc, names[e], e == 1 ? -1.0 : elapsed, failure);
+    }
+    
+    char failure[MAX_FIELD_LENGTH] = "";
+    verifyTableStability(vc->values, size, vc->ascending, failure, sizeof(failure));
+    reportCheck(vc, names[4], -1.0, failure);
+    
+    free(scratch);
+    free(keyCounts);
+}
+
+// ============================================================================
+// USER INTERFACE FUNCTIONS
+// ============================================================================
+
+void printMainMenu() {
+    clearScreen();
+    printf("\n=== INTERACTIVE SORTING ALGORITHMS ===\n");
+    printf("1. Array/Vector Sorting\n");
+    printf("2. Matrix/String Array Sorting\n");
+    printf("3. Linked List Sorting\n");
+    printf("4. Performance Testing Mode\n");
+    printf("5. Compare Benchmark Runs\n");
+    printf("6. Replay Step Trace\n");
+    printf("7. Table Sorting (Multi-Column)\n");
+    printf("8. Verify Sort Engines\n");
+    printf("9. Exit\n");
+    printf("Choose option (1-9): ");
+}
+
+void printAlgorithmMenu(const char* dataType) {
+    printf("\nChoose sorting algorithm for %s:\n", dataType);
+    printf("1. Bubble Sort\n");
+    printf("2. Selection Sort\n");
+    printf("3. Insertion Sort\n");
+    printf("4. Merge Sort\n");
+    printf("5. Quick Sort\n");
+    printf("6. Comb Sort\n");
+    printf("7. Heap Sort\n");
+    printf("8. Counting Sort\n");
+    printf("9. Auto (counting sort for small key ranges)\n");
+    printf("10. Block Merge Sort (stable, square-root scratch)\n");
+    printf("Choice: ");
+}
+
+void printOrderMenu() {
+    printf("Choose sort order:\n");
+    printf("1. Ascending\n");
+    printf("2. Descending\n");
+    printf("Choice: ");
+}
+
+unsigned int promptThreadCount() {
+    unsigned int cpus = detectCpuCount();
+    unsigned int threads;
+    printf("Enter thread count (1-%d, %u CPUs detected): ", SORTLIB_MAX_THREADS, cpus);
+    scanf("%u", &threads);
+    if (threads == 0 || threads > SORTLIB_MAX_THREADS) {
+        printf("Invalid thread count, using %u\n", cpus);
+        threads = cpus;
+    }
+    return threads;
+}
+
+// The pool's parallel engines allocate their large scratch buffers with scratchPages
+sortlib_ThreadPool* startThreadPoolWithPages(unsigned int threads, sortlib_PageMode scratchPages) {
+    sortlib_ThreadPool* pool = sortlib_createThreadPool(threads, scratchPages);
+    if (!pool) {
+        printf("Failed to start the thread pool\n");
+        exit(1);
+    }
+    return pool;
+}
+
+sortlib_ThreadPool* startThreadPool(unsigned int threads) {
+    return startThreadPoolWithPages(threads, SORTLIB_PAGES_DEFAULT);
+}
+
+void printVisualizationMenu(bool traceAvailable) {
+    printf("Show step-by-step visualization?\n");
+    printf("1. Yes\n");
+    printf("2. No\n");
+    if (traceAvailable) {
+        printf("3. Record binary trace to file\n");
+    }
+    printf("Choice: ");
+}
+
+// ============================================================================
+// MAIN SORTING FUNCTIONS
+// ============================================================================
+
+void arraySorting() {
+    clearScreen();
+    printHeader("ARRAY SORTING");
+    
+    // Get array size
+    size_t size;
+    printf("Enter array size: ");
+    scanf("%zu", &size);
+    if (size == 0) {
         printf("Invalid size!\n");
         return;
     }
@@ -691,20 +2095,164 @@ void arraySorting() {
     printf("Choice: ");
     scanf("%d", &choice);
     
-    // Generate or get array
-    int* arr;
+    // Generate or get array
+    int* arr;
+    if (choice == 1) {
+        arr = generateRandomArray(size);
+        printf("Generated random array:\n");
+    } else {
+        arr = getUserArray(size);
+        printf("Your array:\n");
+    }
+    printArray(arr, size);
+    
+    // Get algorithm choice
+    printAlgorithmMenu("Array");
+    scanf("%d", &choice);
+    
+    // Get sort order
+    printOrderMenu();
+    int order;
+    scanf("%d", &order);
+    bool ascending = (order == 1);
+    
+    // Get visualization preference
+    printVisualizationMenu(true);
+    int viz;
+    scanf("%d", &viz);
+    bool showSteps = (viz == 1);
+    
+    // Tracing records every step to disk instead of printing it
+    StepTracer* tracer = NULL;
+    char tracePath[SORTLIB_STRING_LENGTH];
+    if (viz == 3) {
+        printf("Enter trace file path: ");
+        scanf("%99s", tracePath);
+        tracer = startStepTrace(tracePath, arr, size);
+        showSteps = (tracer != NULL);
+    }
+    const sortlib_Observer* observer = tracer ? &tracer->observer : (showSteps ? &consoleObserver : NULL);
+    
+    // Sort the array
+    sortlib_Stats stats;
+    int* arrCopy = malloc(size * sizeof(int));
+    memcpy(arrCopy, arr, size * sizeof(int));
+    
+    switch (choice) {
+        case 1:
+            sortlib_bubbleSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 2:
+            sortlib_selectionSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 3:
+            sortlib_insertionSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 4:
+            sortlib_mergeSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 5:
+            sortlib_quickSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 6:
+            sortlib_combSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 7:
+            sortlib_heapSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 8:
+            sortlib_countingSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 9:
+            sortlib_autoSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        case 10:
+            sortlib_blockMergeSortArray(arrCopy, size, ascending, &stats, observer);
+            break;
+        default:
+            printf("Invalid choice!\n");
+            if (tracer) {
+                unsigned long long events;
+                stopStepTrace(tracer, &events);
+            }
+            free(arrCopy);
+            free(arr);
+            return;
+    }
+    
+    if (tracer) {
+        unsigned long long events;
+        if (stopStepTrace(tracer, &events)) {
+            printf("Recorded %llu events to %s\n", events, tracePath);
+        } else {
+            printf("Could not write trace file %s: recorded %llu events, the file is incomplete\n", tracePath,
+                   events);
+        }
+    }
+    
+    // Display results
+    printHeader("SORTING COMPLETED");
+    printStats(&stats, !showSteps || tracer != NULL);
+    printf("Final sorted array: ");
+    printArray(arrCopy, size);
+    if (choice == 8) {
+        printDistinctCounts(arrCopy, size, ascending);
+    }
+    
+    free(arrCopy);
+    free(arr);
+}
+
+void matrixSorting() {
+    clearScreen();
+    printHeader("MATRIX SORTING");
+    
+    // Get matrix size
+    unsigned int rows;
+    printf("Enter number of strings: ");
+    scanf("%u", &rows);
+    if (rows == 0) {
+        printf("Invalid number!\n");
+        return;
+    }
+    
+    // Get input method
+    int choice;
+    printf("Choose data input method:\n");
+    printf("1. Random data\n");
+    printf("2. User input\n");
+    printf("Choice: ");
+    scanf("%d", &choice);
+    
+    // Generate or get matrix
+    char** matrix;
     if (choice == 1) {
-        arr = generateRandomArray(size);
-        printf("Generated random array:\n");
+        matrix = generateRandomMatrix(rows);
+        printf("Generated random matrix:\n");
     } else {
-        arr = getUserArray(size);
-        printf("Your array:\n");
+        matrix = getUserMatrix(rows);
+        printf("Your matrix:\n");
     }
-    printArray(arr, size);
+    printMatrix(matrix, rows);
     
     // Get algorithm choice
-    printAlgorithmMenu("Array");
+    printf("\nChoose sorting algorithm for Matrix:\n");
+    printf("1. Bubble Sort\n");
+    printf("2. Parallel String Sort (MSD radix + multikey quicksort)\n");
+    printf("3. Collation Sort (locale order, strxfrm keys)\n");
+    printf("4. Case-Insensitive Sort (case-folded keys)\n");
+    printf("Choice: ");
     scanf("%d", &choice);
+    if (choice < 1 || choice > 4) {
+        printf("Invalid choice!\n");
+        freeMatrix(matrix, rows);
+        return;
+    }
+    
+    unsigned int threads = 1;
+    if (choice >= 2) {
+        threads = promptThreadCount();
+    }
     
     // Get sort order
     printOrderMenu();
@@ -713,80 +2261,142 @@ void arraySorting() {
     bool ascending = (order == 1);
     
     // Get visualization preference
-    printVisualizationMenu();
+    printVisualizationMenu(false);
     int viz;
     scanf("%d", &viz);
     bool showSteps = (viz == 1);
     
-    // Sort the array
-    SortStats stats;
-    int* arrCopy = malloc(size * sizeof(int));
-    memcpy(arrCopy, arr, size * sizeof(int));
+    const sortlib_Observer* observer = showSteps ? &consoleObserver : NULL;
+    
+    // Sort the matrix
+    sortlib_Stats stats;
+    if (choice == 1) {
+        sortlib_bubbleSortMatrix(matrix, rows, ascending, &stats, observer);
+    } else {
+        sortlib_ThreadPool* pool = startThreadPool(threads);
+        if (choice == 2) {
+            sortlib_parallelStringSortMatrix(matrix, rows, ascending, &stats, pool, observer);
+        } else {
+            sortlib_CollationMode mode = (choice == 3) ? SORTLIB_COLLATION_LOCALE : SORTLIB_COLLATION_CASE_FOLD;
+            if (!sortlib_collationSortMatrix(matrix, rows, mode, ascending, &stats, pool, observer)) {
+                printf("Memory allocation failed\n");
+                exit(1);
+            }
+        }
+        sortlib_destroyThreadPool(pool);
+    }
+    
+    // Display results
+    printHeader("SORTING COMPLETED");
+    printStats(&stats, !showSteps);
+    printf("Final sorted matrix:\n");
+    printMatrix(matrix, rows);
+    
+    freeMatrix(matrix, rows);
+}
+
+void listSorting() {
+    clearScreen();
+    printHeader("LINKED LIST SORTING");
+    
+    // Get list size
+    unsigned int size;
+    printf("Enter number of strings: ");
+    scanf("%u", &size);
+    if (size == 0) {
+        printf("Invalid number!\n");
+        return;
+    }
+    
+    // Get input method
+    int choice;
+    printf("Choose data input method:\n");
+    printf("1. Random data\n");
+    printf("2. User input\n");
+    printf("Choice: ");
+    scanf("%d", &choice);
+    
+    // Generate or get list
+    sortlib_Node* head;
+    if (choice == 1) {
+        head = generateRandomList(size);
+        printf("Generated random list:\n");
+    } else {
+        head = getUserList(size);
+        printf("Your list:\n");
+    }
+    printList(head);
+    
+    // Get algorithm choice
+    printf("\nChoose sorting algorithm for Linked List:\n");
+    printf("1. Bubble Sort\n");
+    printf("2. Insertion Sort\n");
+    printf("3. Collation Sort (locale order, strxfrm keys)\n");
+    printf("4. Case-Insensitive Sort (case-folded keys)\n");
+    printf("Choice: ");
+    scanf("%d", &choice);
+    
+    // Get sort order
+    printOrderMenu();
+    int order;
+    scanf("%d", &order);
+    bool ascending = (order == 1);
+    
+    // Get visualization preference
+    printVisualizationMenu(false);
+    int viz;
+    scanf("%d", &viz);
+    bool showSteps = (viz == 1);
     
+    const sortlib_Observer* observer = showSteps ? &consoleObserver : NULL;
+    
+    // Sort the list
+    sortlib_Stats stats;
+    bool sorted = true;
     switch (choice) {
         case 1:
-            bubbleSortArray(arrCopy, size, ascending, &stats, showSteps);
+            sortlib_bubbleSortList(&head, ascending, &stats, observer);
             break;
         case 2:
-            selectionSortArray(arrCopy, size, ascending, &stats, showSteps);
+            sortlib_insertionSortList(&head, ascending, &stats, observer);
             break;
         case 3:
-            insertionSortArray(arrCopy, size, ascending, &stats, showSteps);
+            sorted = sortlib_collationSortList(&head, SORTLIB_COLLATION_LOCALE, ascending, &stats, observer);
             break;
         case 4:
-            stats.comparisons = 0;
-            stats.swaps = 0;
-            double startTime = getTimeMs();
-            if (showSteps) {
-                printHeader("MERGE SORT");
-                printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-                printArray(arrCopy, size);
-            }
-            mergeSortArray(arrCopy, 0, size - 1, ascending, &stats, showSteps);
-            stats.execution_time_ms = getTimeMs() - startTime;
-            break;
-        case 5:
-            stats.comparisons = 0;
-            stats.swaps = 0;
-            startTime = getTimeMs();
-            if (showSteps) {
-                printHeader("QUICK SORT");
-                printf("Order: %s\n", ascending ? "Ascending" : "Descending");
-                printArray(arrCopy, size);
-            }
-            quickSortArray(arrCopy, 0, size - 1, ascending, &stats, showSteps);
-            stats.execution_time_ms = getTimeMs() - startTime;
-            break;
-        case 6:
-            combSortArray(arrCopy, size, ascending, &stats, showSteps);
+            sorted = sortlib_collationSortList(&head, SORTLIB_COLLATION_CASE_FOLD, ascending, &stats, observer);
             break;
         default:
             printf("Invalid choice!\n");
-            free(arrCopy);
-            free(arr);
+            freeList(head);
             return;
     }
+    if (!sorted) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
     
     // Display results
     printHeader("SORTING COMPLETED");
     printStats(&stats, !showSteps);
-    printf("Final sorted array: ");
-    printArray(arrCopy, size);
+    printf("Final sorted list: ");
+    printList(head);
     
-    free(arrCopy);
-    free(arr);
+    freeList(head);
 }
 
-void matrixSorting() {
+void tableSorting() {
     clearScreen();
-    printHeader("MATRIX SORTING");
-    
-    // Get matrix size
-    unsigned int rows;
-    printf("Enter number of strings: ");
-    scanf("%u", &rows);
-    if (rows == 0) {
-        printf("Invalid number!\n");
+    printHeader("TABLE SORTING");
+    
+    // Get table size
+    size_t rows, cols;
+    printf("Enter number of rows: ");
+    scanf("%zu", &rows);
+    printf("Enter number of columns: ");
+    scanf("%zu", &cols);
+    if (rows == 0 || cols == 0) {
+        printf("Invalid size!\n");
         return;
     }
     
@@ -798,115 +2408,853 @@ void matrixSorting() {
     printf("Choice: ");
     scanf("%d", &choice);
     
-    // Generate or get matrix
-    char** matrix;
+    // Generate or get table
+    sortlib_IntMatrix* table;
     if (choice == 1) {
-        matrix = generateRandomMatrix(rows);
-        printf("Generated random matrix:\n");
+        table = generateRandomIntMatrix(rows, cols);
+        if (table) printf("Generated random table:\n");
     } else {
-        matrix = getUserMatrix(rows);
-        printf("Your matrix:\n");
+        table = getUserIntMatrix(rows, cols);
+        if (table) printf("Your table:\n");
+    }
+    if (!table) return;
+    printIntMatrix(table);
+    
+    // Get key columns, most significant first
+    size_t numKeys;
+    printf("Enter number of key columns (1-%zu): ", cols);
+    scanf("%zu", &numKeys);
+    if (numKeys == 0 || numKeys > cols) {
+        printf("Invalid number of keys!\n");
+        freeIntMatrix(table);
+        return;
+    }
+    
+    sortlib_Key* keys = malloc(numKeys * sizeof(sortlib_Key));
+    if (!keys) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t k = 0; k < numKeys; k++) {
+        size_t column;
+        printf("Key %zu - column (1-%zu): ", k + 1, cols);
+        scanf("%zu", &column);
+        if (column == 0 || column > cols) {
+            printf("Invalid column!\n");
+            free(keys);
+            freeIntMatrix(table);
+            return;
+        }
+        printOrderMenu();
+        int order;
+        scanf("%d", &order);
+        keys[k].column = column - 1;
+        keys[k].ascending = (order == 1);
+    }
+    
+    // Sort the rows
+    sortlib_Stats stats;
+    if (!sortlib_sortTableRows(table, keys, numKeys, &stats)) {
+        printf("Table too large to sort!\n");
+        free(keys);
+        freeIntMatrix(table);
+        return;
+    }
+    
+    // Display results
+    printHeader("SORTING COMPLETED");
+    printStats(&stats, true);
+    printf("Final sorted table:\n");
+    printIntMatrix(table);
+    
+    free(keys);
+    freeIntMatrix(table);
+}
+
+void printIncrementalRow(const char* mode, const sortlib_Stats* stats, size_t inserted, bool ascending) {
+    recordBenchmarkResult(mode, "random-batched", inserted, 1, ascending, stats);
+    double nsPerElement = inserted ? (stats->execution_time_ms * 1e6) / inserted : 0.0;
+    printf("%-20s %-15.6f %-15.2f %-20llu %-20llu\n", mode, stats->execution_time_ms, nsPerElement,
+           stats->comparisons, stats->swaps);
+}
+
+void incrementalBenchmark(const int* values, size_t size, bool ascending) {
+    size_t batchSize;
+    printf("Enter batch size (elements per append): ");
+    scanf("%zu", &batchSize);
+    if (batchSize == 0 || batchSize > size) {
+        printf("Invalid batch size!\n");
+        return;
+    }
+    
+    size_t batches = (size + batchSize - 1) / batchSize;
+    printf("\nIncremental insertion of %zu elements in %zu batches of %zu...\n", size, batches, batchSize);
+    printf("Order: %s\n\n", ascending ? "Ascending" : "Descending");
+    printf("%-20s %-15s %-15s %-20s %-20s\n", "Mode", "Time (ms)", "ns/element", "Comparisons", "Moves");
+    printf("--------------------------------------------------------------------------------------\n");
+    
+    sortlib_Stats stats;
+    double startTime;
+    
+    // Baseline: append each batch and re-run merge sort over everything.
+    // Total work grows with batches * size, so skip it when that is hopeless.
+    if ((unsigned long long)batches * size <= 1000000000ULL) {
+        int* arr = malloc(size * sizeof(int));
+        if (!arr) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+        sortlib_Stats passStats;
+        stats.comparisons = 0;
+        stats.swaps = 0;
+        beginMemoryMeasurement();
+        startTime = sortlib_timeMs();
+        for (size_t filled = 0; filled < size; ) {
+            size_t count = (size - filled < batchSize) ? size - filled : batchSize;
+            memcpy(arr + filled, values + filled, count * sizeof(int));
+            filled += count;
+            sortlib_mergeSortArray(arr, filled, ascending, &passStats, NULL);
+            stats.comparisons += passStats.comparisons;
+            stats.swaps += passStats.swaps;
+        }
+        stats.execution_time_ms = sortlib_timeMs() - startTime;
+        endMemoryMeasurement(&stats);
+        printIncrementalRow("Re-sort (Merge)", &stats, size, ascending);
+        free(arr);
+    } else {
+        printf("%-20s %s\n", "Re-sort (Merge)", "skipped (too many batches for this size)");
+    }
+    
+    sortlib_SortedContainer sorted;
+    beginMemoryMeasurement();
+    bool ok = sortlib_initSortedContainer(&sorted, batchSize, ascending);
+    startTime = sortlib_timeMs();
+    for (size_t i = 0; i < size && ok; i++) {
+        ok = sortlib_insertSortedContainer(&sorted, values[i]);
+    }
+    if (!ok || !sortlib_flushSortedContainer(&sorted)) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    sorted.stats.execution_time_ms = sortlib_timeMs() - startTime;
+    endMemoryMeasurement(&sorted.stats);
+    printIncrementalRow("Galloping merge", &sorted.stats, size, ascending);
+    
+    sortlib_TieredContainer tiered;
+    beginMemoryMeasurement();
+    ok = sortlib_initTieredContainer(&tiered, batchSize, ascending);
+    int* out = malloc(size * sizeof(int));
+    if (!ok || !out) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    startTime = sortlib_timeMs();
+    for (size_t i = 0; i < size && ok; i++) {
+        ok = sortlib_insertTieredContainer(&tiered, values[i]);
+    }
+    if (!ok || !sortlib_materializeTieredContainer(&tiered, out)) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    tiered.stats.execution_time_ms = sortlib_timeMs() - startTime;
+    endMemoryMeasurement(&tiered.stats);
+    printIncrementalRow("Tiered (LSM)", &tiered.stats, size, ascending);
+    
+    if (memcmp(out, sorted.base, size * sizeof(int)) != 0) {
+        printf("\nWarning: incremental containers disagree on the final order!\n");
+    }
+    
+    free(out);
+    sortlib_freeTieredContainer(&tiered);
+    sortlib_freeSortedContainer(&sorted);
+}
+
+void parallelScalingBenchmark(const int* values, size_t size, bool ascending) {
+    printf("Maximum threads for the scaling run:\n");
+    unsigned int maxThreads = promptThreadCount();
+    
+    int* arrCopy = malloc(size * sizeof(int));
+    if (!arrCopy) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    
+    printf("\nParallel scaling, Size: %zu, Order: %s\n\n", size, ascending ? "Ascending" : "Descending");
+    printf("%-15s %-10s %-15s %-10s %-12s\n", "Algorithm", "Threads", "Time (ms)", "Speedup", "Efficiency");
+    printf("----------------------------------------------------------------\n");
+    
+    const char* algorithms[] = {"Sample Sort", "Radix Sort", "Counting Sort"};
+    sortlib_Stats stats;
+    
+    for (int alg = 0; alg < 3; alg++) {
+        double baseTime = 0.0;
+        for (unsigned int threads = 1; threads <= maxThreads; ) {
+            sortlib_ThreadPool* pool = startThreadPool(threads);
+            memcpy(arrCopy, values, size * sizeof(int));
+            if (alg == 0) {
+                beginMemoryMeasurement();
+                sortlib_parallelSampleSortArray(arrCopy, size, ascending, &stats, pool);
+                endMemoryMeasurement(&stats);
+            } else if (alg == 1) {
+                beginMemoryMeasurement();
+                sortlib_parallelRadixSortArray(arrCopy, size, ascending, &stats, pool);
+                endMemoryMeasurement(&stats);
+            } else {
+                beginMemoryMeasurement();
+                sortlib_parallelCountingSortArray(arrCopy, size, ascending, &stats, pool);
+                endMemoryMeasurement(&stats);
+            }
+            sortlib_destroyThreadPool(pool);
+            
+            recordBenchmarkResult(algorithms[alg], "random", size, threads, ascending, &stats);
+            if (threads == 1) baseTime = stats.execution_time_ms;
+            double speedup = stats.execution_time_ms > 0.0 ? baseTime / stats.execution_time_ms : 0.0;
+            printf("%-15s %-10u %-15.6f %-10.2f %.1f%%\n", algorithms[alg], threads,
+                   stats.execution_time_ms, speedup, 100.0 * speedup / threads);
+            
+            threads = nextThreadCount(threads, maxThreads);
+        }
+    }
+    
+    free(arrCopy);
+}
+
+int compareStrcoll(const void* a, const void* b) {
+    return strcoll(*(char* const*)a, *(char* const*)b);
+}
+
+int compareStrcollDescending(const void* a, const void* b) {
+    return strcoll(*(char* const*)b, *(char* const*)a);
+}
+
+void stringSortBenchmark(unsigned int rows, bool ascending) {
+    printf("Maximum threads for the scaling run:\n");
+    unsigned int maxThreads = promptThreadCount();
+    
+    printf("Generating random matrix of %u strings...\n", rows);
+    char** matrix = generateRandomMatrix(rows);
+    char** rowsCopy = malloc(rows * sizeof(char*));
+    if (!rowsCopy) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    
+    printf("\nString sorting, Strings: %u, Order: %s\n\n", rows, ascending ? "Ascending" : "Descending");
+    printf("%-22s %-10s %-15s %-15s %-10s\n", "Algorithm", "Threads", "Time (ms)", "Comparisons", "Speedup");
+    printf("--------------------------------------------------------------------------\n");
+    
+    sortlib_Stats stats;
+    
+    // Bubble sort swaps string contents, so it gets its own deep copy
+    if (rows <= 20000) {
+        char** bubbleCopy = malloc(rows * sizeof(char*));
+        if (!bubbleCopy) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+        for (unsigned int i = 0; i < rows; i++) {
+            bubbleCopy[i] = malloc(SORTLIB_STRING_LENGTH * sizeof(char));
+            if (!bubbleCopy[i]) {
+                printf("Memory allocation failed\n");
+                exit(1);
+            }
+            strcpy(bubbleCopy[i], matrix[i]);
+        }
+        beginMemoryMeasurement();
+        sortlib_bubbleSortMatrix(bubbleCopy, rows, ascending, &stats, NULL);
+        endMemoryMeasurement(&stats);
+        recordBenchmarkResult("Bubble Sort (strings)", "random-words", rows, 1, ascending, &stats);
+        printf("%-22s %-10u %-15.6f %-15llu %-10s\n", "Bubble Sort", 1u, stats.execution_time_ms, stats.comparisons, "-");
+        freeMatrix(bubbleCopy, rows);
+    } else {
+        printf("%-22s %s\n", "Bubble Sort", "skipped (quadratic, more than 20000 strings)");
+    }
+    
+    double baseTime = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads; ) {
+        sortlib_ThreadPool* pool = startThreadPool(threads);
+        memcpy(rowsCopy, matrix, rows * sizeof(char*));
+        beginMemoryMeasurement();
+        sortlib_parallelStringSortMatrix(rowsCopy, rows, ascending, &stats, pool, NULL);
+        endMemoryMeasurement(&stats);
+        sortlib_destroyThreadPool(pool);
+        recordBenchmarkResult("Parallel String Sort", "random-words", rows, threads, ascending, &stats);
+        
+        if (threads == 1) baseTime = stats.execution_time_ms;
+        double speedup = stats.execution_time_ms > 0.0 ? baseTime / stats.execution_time_ms : 0.0;
+        printf("%-22s %-10u %-15.6f %-15llu %-10.2f\n", "Parallel String Sort", threads,
+               stats.execution_time_ms, stats.comparisons, speedup);
+        threads = nextThreadCount(threads, maxThreads);
+    }
+    
+    // Collation: strcoll on every comparison against keys transformed once
+    char** collationCopy = malloc(rows * sizeof(char*));
+    if (!collationCopy) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    memcpy(collationCopy, matrix, rows * sizeof(char*));
+    double start = sortlib_timeMs();
+    qsort(collationCopy, rows, sizeof(char*), ascending ? compareStrcoll : compareStrcollDescending);
+    double strcollTime = sortlib_timeMs() - start;
+    printf("%-22s %-10u %-15.6f %-15s %-10s\n", "strcoll compare", 1u, strcollTime, "-", "-");
+    
+    const char* collationNames[] = {"Collation Keys", "Case-Fold Keys"};
+    for (int mode = SORTLIB_COLLATION_LOCALE; mode <= SORTLIB_COLLATION_CASE_FOLD; mode++) {
+        for (unsigned int threads = 1; threads <= maxThreads; ) {
+            sortlib_ThreadPool* pool = startThreadPool(threads);
+            memcpy(rowsCopy, matrix, rows * sizeof(char*));
+            beginMemoryMeasurement();
+            bool sorted = sortlib_collationSortMatrix(rowsCopy, rows, mode, ascending, &stats, pool, NULL);
+            endMemoryMeasurement(&stats);
+            if (!sorted) {
+                printf("Memory allocation failed\n");
+                exit(1);
+            }
+            sortlib_destroyThreadPool(pool);
+            recordBenchmarkResult(collationNames[mode], "random-words", rows, threads, ascending, &stats);
+            
+            double speedup = stats.execution_time_ms > 0.0 ? strcollTime / stats.execution_time_ms : 0.0;
+            printf("%-22s %-10u %-15.6f %-15llu %-10.2f\n", collationNames[mode], threads,
+                   stats.execution_time_ms, stats.comparisons, speedup);
+            threads = nextThreadCount(threads, maxThreads);
+        }
+    }
+    printf("\nCollation speedups are against strcoll compare (LC_COLLATE=%s)\n", setlocale(LC_COLLATE, NULL));
+    
+    free(collationCopy);
+    free(rowsCopy);
+    freeMatrix(matrix, rows);
+}
+
+void orderSpecializationBenchmark(const int* values, size_t size, bool ascending) {
+    int* arrCopy = malloc(size * sizeof(int));
+    if (!arrCopy) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    
+    printf("\nRuntime order check vs order-specialized kernels\n");
+    printf("Size: %zu, Order: %s\n\n", size, ascending ? "Ascending" : "Descending");
+    printf("%-22s %-18s %-18s %-10s\n", "Algorithm", "Runtime (ms)", "Specialized (ms)", "Gain");
+    printf("----------------------------------------------------------------------\n");
+    
+    sortlib_Stats runtimeStats, specializedStats;
+    char name[MAX_FIELD_LENGTH];
+    
+    for (int i = 0; i < NUM_RUNTIME_ORDER_ALGORITHMS; i++) {
+        memcpy(arrCopy, values, size * sizeof(int));
+        beginMemoryMeasurement();
+        sortlib_runtimeOrderAlgorithms[i].sort(arrCopy, size, ascending, &runtimeStats, NULL);
+        endMemoryMeasurement(&runtimeStats);
+        memcpy(arrCopy, values, size * sizeof(int));
+        beginMemoryMeasurement();
+        sortlib_arrayAlgorithms[i].sort(arrCopy, size, ascending, &specializedStats, NULL);
+        endMemoryMeasurement(&specializedStats);
+        
+        snprintf(name, sizeof(name), "%s [runtime order]", sortlib_arrayAlgorithms[i].name);
+        recordBenchmarkResult(name, "random", size, 1, ascending, &runtimeStats);
+        recordBenchmarkResult(sortlib_arrayAlgorithms[i].name, "random", size, 1, ascending, &specializedStats);
+        
+        double gain = specializedStats.execution_time_ms > 0.0
+            ? 100.0 * (runtimeStats.execution_time_ms / specializedStats.execution_time_ms - 1.0) : 0.0;
+        printf("%-22s %-18.6f %-18.6f %+.1f%%\n", sortlib_arrayAlgorithms[i].name,
+               runtimeStats.execution_time_ms, specializedStats.execution_time_ms, gain);
+    }
+    free(arrCopy);
+    
+    // Bubble sort swaps string contents, so each variant sorts its own matrix
+    if (size <= 20000) {
+        unsigned int rows = (unsigned int)size;
+        char** runtimeMatrix = generateRandomMatrix(rows);
+        char** specializedMatrix = malloc(rows * sizeof(char*));
+        if (!specializedMatrix) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+        for (unsigned int i = 0; i < rows; i++) {
+            specializedMatrix[i] = malloc(SORTLIB_STRING_LENGTH * sizeof(char));
+            if (!specializedMatrix[i]) {
+                printf("Memory allocation failed\n");
+                exit(1);
+            }
+            strcpy(specializedMatrix[i], runtimeMatrix[i]);
+        }
+        
+        beginMemoryMeasurement();
+        sortlib_bubbleSortMatrixRuntimeOrder(runtimeMatrix, rows, ascending, &runtimeStats, NULL);
+        endMemoryMeasurement(&runtimeStats);
+        beginMemoryMeasurement();
+        sortlib_bubbleSortMatrix(specializedMatrix, rows, ascending, &specializedStats, NULL);
+        endMemoryMeasurement(&specializedStats);
+        recordBenchmarkResult("Bubble Sort (strings) [runtime order]", "random-words", size, 1, ascending, &runtimeStats);
+        recordBenchmarkResult("Bubble Sort (strings)", "random-words", size, 1, ascending, &specializedStats);
+        
+        double gain = specializedStats.execution_time_ms > 0.0
+            ? 100.0 * (runtimeStats.execution_time_ms / specializedStats.execution_time_ms - 1.0) : 0.0;
+        printf("%-22s %-18.6f %-18.6f %+.1f%%\n", "Bubble Sort (strings)",
+               runtimeStats.execution_time_ms, specializedStats.execution_time_ms, gain);
+        
+        freeMatrix(specializedMatrix, rows);
+        freeMatrix(runtimeMatrix, rows);
+    }
+}
+
+void heapArityBenchmark(const int* values, size_t size, bool ascending) {
+    const unsigned int arities[] = {2, 4, 8};
+    int* arrCopy = malloc(size * sizeof(int));
+    if (!arrCopy) {
+        printf("Memory allocation failed\n");
+        exit(1);
     }
-    printMatrix(matrix, rows);
-    
-    // Get sort order
-    printOrderMenu();
-    int order;
-    scanf("%d", &order);
-    bool ascending = (order == 1);
-    
-    // Get visualization preference
-    printVisualizationMenu();
-    int viz;
-    scanf("%d", &viz);
-    bool showSteps = (viz == 1);
     
-    // Sort the matrix
-    SortStats stats;
-    bubbleSortMatrix(matrix, rows, ascending, &stats, showSteps);
+    printf("\nBinary vs d-ary heaps, Size: %zu (%.1f MB), Order: %s\n\n", size,
+           size * sizeof(int) / (1024.0 * 1024.0), ascending ? "Ascending" : "Descending");
+    printf("%-22s %-8s %-15s %-20s %-20s\n", "Benchmark", "Arity", "Time (ms)", "Comparisons", "Moves");
+    printf("--------------------------------------------------------------------------------------\n");
+    
+    sortlib_Stats stats;
+    char name[MAX_FIELD_LENGTH];
+    for (int a = 0; a < 3; a++) {
+        memcpy(arrCopy, values, size * sizeof(int));
+        beginMemoryMeasurement();
+        sortlib_heapSortArrayWithArity(arrCopy, size, arities[a], ascending, &stats, NULL);
+        endMemoryMeasurement(&stats);
+        snprintf(name, sizeof(name), "Heap Sort (%u-ary)", arities[a]);
+        recordBenchmarkResult(name, "random", size, 1, ascending, &stats);
+        printf("%-22s %-8u %-15.6f %-20llu %-20llu\n", "Heap Sort", arities[a],
+               stats.execution_time_ms, stats.comparisons, stats.swaps);
+    }
     
-    // Display results
-    printHeader("SORTING COMPLETED");
-    printStats(&stats, !showSteps);
-    printf("Final sorted matrix:\n");
-    printMatrix(matrix, rows);
+    // Priority queue: push everything, then pop everything
+    for (int a = 0; a < 3; a++) {
+        beginMemoryMeasurement();
+        sortlib_PriorityQueue* pq = sortlib_createPriorityQueue(arities[a], ascending, size);
+        if (!pq) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+        sortlib_HeapEntry entry = {0};
+        double startTime = sortlib_timeMs();
+        for (size_t i = 0; i < size; i++) {
+            if (!sortlib_pushPriorityQueue(pq, values[i], i)) {
+                printf("Memory allocation failed\n");
+                exit(1);
+            }
+        }
+        for (size_t i = 0; i < size; i++) {
+            sortlib_popPriorityQueue(pq, &entry);
+            arrCopy[i] = entry.key;
+        }
+        pq->stats.execution_time_ms = sortlib_timeMs() - startTime;
+        endMemoryMeasurement(&pq->stats);
+        snprintf(name, sizeof(name), "Priority Queue (%u-ary)", arities[a]);
+        recordBenchmarkResult(name, "random", size, 1, ascending, &pq->stats);
+        printf("%-22s %-8u %-15.6f %-20llu %-20llu\n", "Priority Queue", arities[a],
+               pq->stats.execution_time_ms, pq->stats.comparisons, pq->stats.swaps);
+        sortlib_freePriorityQueue(pq);
+    }
     
-    freeMatrix(matrix, rows);
+    free(arrCopy);
 }
 
-void listSorting() {
-    clearScreen();
-    printHeader("LINKED LIST SORTING");
-    
-    // Get list size
-    unsigned int size;
-    printf("Enter number of strings: ");
-    scanf("%u", &size);
-    if (size == 0) {
-        printf("Invalid number!\n");
+void printBatchRow(const char* algorithm, unsigned int threads, size_t arrays, size_t elements, bool ascending,
+                   const sortlib_Stats* stats) {
+    recordBenchmarkResult(algorithm, "tiny-arrays", arrays, threads, ascending, stats);
+    double seconds = stats->execution_time_ms / 1000.0;
+    double arraysPerSecond = seconds > 0.0 ? arrays / seconds : 0.0;
+    double elementsPerSecond = seconds > 0.0 ? elements / seconds : 0.0;
+    printf("%-22s %-10u %-15.6f %-14.3f %-14.2f\n", algorithm, threads, stats->execution_time_ms,
+           arraysPerSecond / 1e6, elementsPerSecond / 1e6);
+}
+
+void tinyArrayBenchmark(size_t arrays, bool ascending) {
+    size_t minLength, maxLength;
+    printf("Enter minimum and maximum array length (e.g. 8 64): ");
+    scanf("%zu %zu", &minLength, &maxLength);
+    if (minLength == 0 || maxLength < minLength) {
+        printf("Invalid lengths!\n");
         return;
     }
+    printf("Maximum threads for the batched run:\n");
+    unsigned int maxThreads = promptThreadCount();
     
-    // Get input method
-    int choice;
-    printf("Choose data input method:\n");
-    printf("1. Random data\n");
-    printf("2. User input\n");
-    printf("Choice: ");
-    scanf("%d", &choice);
+    size_t* offsets = malloc((arrays + 1) * sizeof(size_t));
+    if (!offsets) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    srand(time(NULL));
+    offsets[0] = 0;
+    for (size_t i = 0; i < arrays; i++) {
+        offsets[i + 1] = offsets[i] + minLength + (size_t)rand() % (maxLength - minLength + 1);
+    }
+    size_t elements = offsets[arrays];
     
-    // Generate or get list
-    Node* head;
-    if (choice == 1) {
-        head = generateRandomList(size);
-        printf("Generated random list:\n");
-    } else {
-        head = getUserList(size);
-        printf("Your list:\n");
+    printf("Generating %zu arrays (%zu elements)...\n", arrays, elements);
+    int* values = generateRandomArray(elements);
+    int* data = malloc(elements * sizeof(int));
+    if (!data) {
+        printf("Memory allocation failed\n");
+        exit(1);
     }
-    printList(head);
     
-    // Get algorithm choice
-    printf("\nChoose sorting algorithm for Linked List:\n");
-    printf("1. Bubble Sort\n");
-    printf("2. Insertion Sort\n");
-    printf("Choice: ");
-    scanf("%d", &choice);
+    printf("\nTiny array batches, Arrays: %zu, Lengths: %zu-%zu, Order: %s\n\n", arrays, minLength, maxLength,
+           ascending ? "Ascending" : "Descending");
+    printf("%-22s %-10s %-15s %-14s %-14s\n", "Algorithm", "Threads", "Time (ms)", "M arrays/s", "M elements/s");
+    printf("---------------------------------------------------------------------------\n");
+    
+    // Baseline: one sortlib_insertionSortArray call per array
+    sortlib_Stats stats, arrayStats;
+    memcpy(data, values, elements * sizeof(int));
+    stats.comparisons = 0;
+    stats.swaps = 0;
+    beginMemoryMeasurement();
+    double startTime = sortlib_timeMs();
+    for (size_t i = 0; i < arrays; i++) {
+        sortlib_insertionSortArray(data + offsets[i], offsets[i + 1] - offsets[i], ascending, &arrayStats, NULL);
+        stats.comparisons += arrayStats.comparisons;
+        stats.swaps += arrayStats.swaps;
+    }
+    stats.execution_time_ms = sortlib_timeMs() - startTime;
+    endMemoryMeasurement(&stats);
+    printBatchRow("Insertion per array", 1, arrays, elements, ascending, &stats);
+    
+    memcpy(data, values, elements * sizeof(int));
+    beginMemoryMeasurement();
+    sortlib_sortArrayBatch(data, offsets, arrays, ascending, false, &stats, NULL);
+    endMemoryMeasurement(&stats);
+    printBatchRow("Network batch", 1, arrays, elements, ascending, &stats);
+    
+    for (unsigned int threads = 1; threads <= maxThreads; ) {
+        sortlib_ThreadPool* pool = startThreadPool(threads);
+        memcpy(data, values, elements * sizeof(int));
+        beginMemoryMeasurement();
+        sortlib_sortArrayBatch(data, offsets, arrays, ascending, true, &stats, pool);
+        endMemoryMeasurement(&stats);
+        sortlib_destroyThreadPool(pool);
+        printBatchRow("Network batch (lanes)", threads, arrays, elements, ascending, &stats);
+        
+        threads = nextThreadCount(threads, maxThreads);
+    }
     
-    // Get sort order
-    printOrderMenu();
-    int order;
-    scanf("%d", &order);
-    bool ascending = (order == 1);
+    free(data);
+    free(values);
+    free(offsets);
+}
+
+// Data TLB read misses of this process and the threads it creates afterwards
+// (inherit), counted in user space only. Returns -1 where perf events are
+// unavailable (non-Linux, perf_event_paranoid, no PMU in a VM).
+int openTlbMissCounter() {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+void startTlbMissCounter(int fd) {
+#ifdef __linux__
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#else
+    (void)fd;
+#endif
+}
+
+// Inherited counts reach the parent when the child threads exit, so read
+// after the pool is destroyed; -1 when no counter is available
+long long readTlbMissCounter(int fd) {
+#ifdef __linux__
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long count;
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+    return count;
+#else
+    (void)fd;
+    return -1;
+#endif
+}
+
+void hugePageBenchmark(size_t size, bool ascending) {
+    printf("Threads for the sorts (first touch uses the same threads):\n");
+    unsigned int threads = promptThreadCount();
+    
+    printf("Generating random array of size %zu...\n", size);
+    int* values = generateRandomArray(size);
+    size_t bytes = size * sizeof(int);
+    
+    const sortlib_PageMode modes[] = {SORTLIB_PAGES_DEFAULT, SORTLIB_PAGES_DEFAULT, SORTLIB_PAGES_TRANSPARENT_HUGE,
+                                      SORTLIB_PAGES_EXPLICIT_HUGE};
+    const bool firstTouch[] = {false, true, true, true};
+    const char* algorithms[] = {"Radix Sort", "Sample Sort"};
+    
+    printf("\nPage size and placement, Size: %zu (%.1f MB), Threads: %u, Order: %s\n\n", size,
+           bytes / (1024.0 * 1024.0), threads, ascending ? "Ascending" : "Descending");
+    printf("%-28s %-12s %-15s %-14s %-15s\n", "Buffers", "Algorithm", "Time (ms)", "M elements/s", "dTLB misses");
+    printf("-----------------------------------------------------------------------------------------\n");
+    
+    bool countersAvailable = true;
+    bool fellBack = false;
+    for (int m = 0; m < 4; m++) {
+        for (int alg = 0; alg < 2; alg++) {
+            // The counter has to exist before the pool threads so they inherit it
+            int counter = openTlbMissCounter();
+            
+            // The scratch buffers get the pages the data buffer actually got
+            sortlib_PageMode used;
+            int* data = sortlib_allocLargeBuffer(bytes, modes[m], &used);
+            if (!data) {
+                printf("Memory allocation failed\n");
+                exit(1);
+            }
+            sortlib_ThreadPool* pool = startThreadPoolWithPages(threads, used);
+            if (firstTouch[m]) {
+                sortlib_firstTouchBuffer(data, bytes, pool);
+            }
+            memcpy(data, values, bytes);
+            
+            sortlib_Stats stats;
+            startTlbMissCounter(counter);
+            beginMemoryMeasurement();
+            if (alg == 0) {
+                sortlib_parallelRadixSortArray(data, size, ascending, &stats, pool);
+            } else {
+                sortlib_parallelSampleSortArray(data, size, ascending, &stats, pool);
+            }
+            endMemoryMeasurement(&stats);
+            sortlib_destroyThreadPool(pool);
+            long long misses = readTlbMissCounter(counter);
+            if (counter >= 0) close(counter);
+            if (used != modes[m]) fellBack = true;
+            
+            char label[MAX_FIELD_LENGTH / 2];
+            char name[MAX_FIELD_LENGTH];
+            snprintf(label, sizeof(label), "%s%s%s", sortlib_pageModeName(used), firstTouch[m] ? " + first touch" : "",
+                     used != modes[m] ? "*" : "");
+            snprintf(name, sizeof(name), "%s [%s]", algorithms[alg], label);
+            recordBenchmarkResult(name, "random", size, threads, ascending, &stats);
+            
+            double seconds = stats.execution_time_ms / 1000.0;
+            printf("%-28s %-12s %-15.6f %-14.2f ", label, algorithms[alg], stats.execution_time_ms,
+                   seconds > 0.0 ? size / seconds / 1e6 : 0.0);
+            if (misses >= 0) {
+                printf("%lld\n", misses);
+            } else {
+                printf("n/a\n");
+                countersAvailable = false;
+            }
+            
+            sortlib_freeLargeBuffer(data, bytes);
+        }
+    }
     
-    // Get visualization preference
-    printVisualizationMenu();
-    int viz;
-    scanf("%d", &viz);
-    bool showSteps = (viz == 1);
+    printf("\n");
+    if (fellBack) {
+        printf("* requested mode unavailable (no reserved huge pages or THP disabled); fallback shown\n");
+    }
+    if (!countersAvailable) {
+        printf("dTLB counters unavailable (needs Linux perf events and perf_event_paranoid <= 2)\n");
+    }
+    free(values);
+}
+
+void printTypedRow(const char* type, const char* algorithm, size_t elementSize, size_t size, bool ascending,
+                   const sortlib_Stats* stats) {
+    char name[MAX_FIELD_LENGTH];
+    snprintf(name, sizeof(name), "%s [%s]", algorithm, type);
+    recordBenchmarkResult(name, "random", size, 1, ascending, stats);
+    
+    double seconds = stats->execution_time_ms / 1000.0;
+    double elementsPerSecond = seconds > 0.0 ? size / seconds : 0.0;
+    printf("%-10s %-16s %-15.6f %-14.2f %-14.2f\n", type, algorithm, stats->execution_time_ms,
+           elementsPerSecond / 1e6, elementsPerSecond * elementSize / 1e6);
+}
+
+// Random keys per type: full-range integers, floats in roughly +-2^21 with one
+// NaN in every 1024 values
+#define INT32_FROM_BITS(bits) ((int32_t)(uint32_t)(bits))
+#define INT64_FROM_BITS(bits) ((int64_t)(bits))
+#define UINT32_FROM_BITS(bits) ((uint32_t)(bits))
+#define UINT64_FROM_BITS(bits) ((uint64_t)(bits))
+#define FLOAT_FROM_BITS(bits) (((bits) & 1023) == 0 ? NAN : (float)INT32_FROM_BITS(bits) / 1024.0f)
+#define DOUBLE_FROM_BITS(bits) (((bits) & 1023) == 0 ? NAN : (double)INT64_FROM_BITS(bits) / 4096.0)
+
+#define GENERATE_TYPED_BENCHMARK(TYPE, NAME, FROM_BITS)                                             \
+void typedBenchmark##NAME(size_t size, bool ascending) {                                            \
+    TYPE* values = malloc(size * sizeof(TYPE));                                                     \
+    TYPE* arrCopy = malloc(size * sizeof(TYPE));                                                    \
+    if (!values || !arrCopy) {                                                                      \
+        printf("Memory allocation failed\n");                                                       \
+        exit(1);                                                                                    \
+    }                                                                                               \
+    for (size_t i = 0; i < size; i++) {                                                             \
+        uint64_t bits = randomBits64();                                                             \
+        values[i] = FROM_BITS(bits);                                                                \
+    }                                                                                               \
+                                                                                                    \
+    const char* names[] = {"Insertion Sort", "Merge Sort", "Quick Sort", "Heap Sort", "Radix Sort"}; \
+    void (*sorts[])(TYPE*, size_t, bool, sortlib_Stats*) = {                                        \
+        sortlib_insertionSort##NAME, sortlib_mergeSort##NAME, sortlib_quickSort##NAME, sortlib_heapSort##NAME, \
+        sortlib_radixSort##NAME                                                                     \
+    };                                                                                              \
+    sortlib_Stats stats;                                                                            \
+    for (int e = 0; e < 5; e++) {                                                                   \
+        if (e == 0 && size > 20000) continue;  /* Quadratic */                                      \
+        memcpy(arrCopy, values, size * sizeof(TYPE));                                               \
+        beginMemoryMeasurement();                                                                   \
+        sorts[e](arrCopy, size, ascending, &stats);                                                 \
+        endMemoryMeasurement(&stats);                                                               \
+        printTypedRow(#TYPE, names[e], sizeof(TYPE), size, ascending, &stats);                      \
+    }                                                                                               \
+                                                                                                    \
+    free(arrCopy);                                                                                  \
+    free(values);                                                                                   \
+}
+
+GENERATE_TYPED_BENCHMARK(int32_t, Int32, INT32_FROM_BITS)
+GENERATE_TYPED_BENCHMARK(int64_t, Int64, INT64_FROM_BITS)
+GENERATE_TYPED_BENCHMARK(uint32_t, UInt32, UINT32_FROM_BITS)
+GENERATE_TYPED_BENCHMARK(uint64_t, UInt64, UINT64_FROM_BITS)
+GENERATE_TYPED_BENCHMARK(float, Float, FLOAT_FROM_BITS)
+GENERATE_TYPED_BENCHMARK(double, Double, DOUBLE_FROM_BITS)
+
+void typeThroughputBenchmark(size_t size, bool ascending) {
+    printf("\nTyped engines per key type (insertion sort up to 20000 elements)\n");
+    printf("Size: %zu, Order: %s\n\n", size, ascending ? "Ascending" : "Descending");
+    printf("%-10s %-16s %-15s %-14s %-14s\n", "Type", "Algorithm", "Time (ms)", "M elements/s", "MB/s");
+    printf("-------------------------------------------------------------------------\n");
+    
+    typedBenchmarkInt32(size, ascending);
+    typedBenchmarkInt64(size, ascending);
+    typedBenchmarkUInt32(size, ascending);
+    typedBenchmarkUInt64(size, ascending);
+    typedBenchmarkFloat(size, ascending);
+    typedBenchmarkDouble(size, ascending);
+}
+
+// Stable sorting within a scratch budget: merge sort's half-size buffer against
+// block merge sort with no scratch, a square root's worth, the user's budget
+// and the same buffer as merge sort
+void blockMergeBenchmark(const int* values, size_t size, bool ascending) {
+    size_t budgetKb;
+    printf("Scratch budget for block merge sort in KB (0 = square root of the size only): ");
+    scanf("%zu", &budgetKb);
     
-    // Sort the list
-    SortStats stats;
-    switch (choice) {
-        case 1:
-            bubbleSortList(&head, ascending, &stats, showSteps);
-            break;
-        case 2:
-            insertionSortList(&head, ascending, &stats, showSteps);
-            break;
-        default:
-            printf("Invalid choice!\n");
-            freeList(head);
-            return;
+    int* arrCopy = malloc(size * sizeof(int));
+    if (!arrCopy) {
+        printf("Memory allocation failed\n");
+        exit(1);
     }
     
-    // Display results
-    printHeader("SORTING COMPLETED");
-    printStats(&stats, !showSteps);
-    printf("Final sorted list: ");
-    printList(head);
+    printf("\nStable sort under a memory budget, Size: %zu, Order: %s\n\n", size,
+           ascending ? "Ascending" : "Descending");
+    printf("%-28s %-15s %-15s %-15s %-15s %-15s\n", "Algorithm", "Buffer (ints)", "Time (ms)", "Swaps",
+           "Peak heap (KB)", "Peak RSS (KB)");
+    printf("------------------------------------------------------------------------------------------------------\n");
+    
+    sortlib_Stats stats;
+    memcpy(arrCopy, values, size * sizeof(int));
+    beginMemoryMeasurement();
+    sortlib_mergeSortArray(arrCopy, size, ascending, &stats, NULL);
+    endMemoryMeasurement(&stats);
+    recordBenchmarkResult("Merge Sort", "random", size, 1, ascending, &stats);
+    printf("%-28s %-15zu %-15.6f %-15llu %-15zu %-15ld\n", "Merge Sort", sortlib_sortScratchBytes(size) / sizeof(int),
+           stats.execution_time_ms, stats.swaps, (stats.peakHeapBytes + 1023) / 1024, stats.peakRssKb);
+    
+    size_t buffers[] = {0, sortlib_blockMergeBufferLength(size), budgetKb * 1024 / sizeof(int), size / 2};
+    const char* labels[] = {"Block Merge [no scratch]", "Block Merge [sqrt n]", "Block Merge [budget]",
+                            "Block Merge [n/2]"};
+    char name[MAX_FIELD_LENGTH];
+    for (int b = 0; b < 4; b++) {
+        if (b == 2 && budgetKb == 0) continue;
+        memcpy(arrCopy, values, size * sizeof(int));
+        beginMemoryMeasurement();
+        sortlib_blockMergeSortArrayWithBuffer(arrCopy, size, buffers[b], ascending, &stats, NULL);
+        endMemoryMeasurement(&stats);
+        snprintf(name, sizeof(name), "Block Merge [%zu ints]", buffers[b]);
+        recordBenchmarkResult(name, "random", size, 1, ascending, &stats);
+        printf("%-28s %-15zu %-15.6f %-15llu %-15zu %-15ld\n", labels[b], buffers[b], stats.execution_time_ms,
+               stats.swaps, (stats.peakHeapBytes + 1023) / 1024, stats.peakRssKb);
+    }
     
-    freeList(head);
+    free(arrCopy);
+}
+
+// Counting sort against quick sort as the key range grows past the array
+// size; Auto should track the faster of the two. Keys are centred on zero.
+void keyRangeBenchmark(size_t size, bool ascending) {
+    int* values = malloc(size * sizeof(int));
+    int* arrCopy = malloc(size * sizeof(int));
+    int* distinctValues = malloc(size * sizeof(int));
+    size_t* distinctCounts = malloc(size * sizeof(size_t));
+    if (!values || !arrCopy || !distinctValues || !distinctCounts) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    
+    printf("\nKey range, Size: %zu, Order: %s\n\n", size, ascending ? "Ascending" : "Descending");
+    printf("%-14s %-16s %-15s %-15s %-15s\n", "Range", "Algorithm", "Time (ms)", "Comparisons", "Peak heap (KB)");
+    printf("-------------------------------------------------------------------------------\n");
+    
+    const uint64_t ranges[] = {16, 1024, size / 4 + 1, size, 4 * (uint64_t)size, 16 * (uint64_t)size,
+                               (uint64_t)UINT32_MAX + 1};
+    const char* names[] = {"Quick Sort", "Counting Sort", "Auto"};
+    sortlib_ArraySortFunction sorts[] = {sortlib_quickSortArray, sortlib_countingSortArray, sortlib_autoSortArray};
+    sortlib_Stats stats;
+    char distribution[MAX_FIELD_LENGTH];
+    
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        uint64_t range = ranges[r] > (uint64_t)UINT32_MAX + 1 ? (uint64_t)UINT32_MAX + 1 : ranges[r];
+        int64_t low = -(int64_t)(range / 2);
+        for (size_t i = 0; i < size; i++) {
+            values[i] = (int)(low + (int64_t)(randomBits64() % range));
+        }
+        snprintf(distribution, sizeof(distribution), "range-%llu", (unsigned long long)range);
+        
+        for (int alg = 0; alg < 3; alg++) {
+            memcpy(arrCopy, values, size * sizeof(int));
+            beginMemoryMeasurement();
+            sorts[alg](arrCopy, size, ascending, &stats, NULL);
+            endMemoryMeasurement(&stats);
+            recordBenchmarkResult(names[alg], distribution, size, 1, ascending, &stats);
+            printf("%-14llu %-16s %-15.6f %-15llu %-15zu\n", (unsigned long long)range, names[alg],
+                   stats.execution_time_ms, stats.comparisons, (stats.peakHeapBytes + 1023) / 1024);
+        }
+        
+        beginMemoryMeasurement();
+        size_t distinct = sortlib_countDistinctInts(values, size, ascending, distinctValues, distinctCounts, &stats);
+        endMemoryMeasurement(&stats);
+        recordBenchmarkResult("Distinct Counts", distribution, size, 1, ascending, &stats);
+        printf("%-14llu %-16s %-15.6f %-15llu %-15zu %zu distinct\n", (unsigned long long)range,
+               "Distinct Counts", stats.execution_time_ms, stats.comparisons,
+               (stats.peakHeapBytes + 1023) / 1024, distinct);
+        
+        int minValue, maxValue;
+        sortlib_Stats rangeStats = {0};
+        sortlib_intRange(values, size, &minValue, &maxValue, &rangeStats);
+        const char* choice = sortlib_countingSortWins(size, sortlib_intRangeLength(minValue, maxValue)) ? "Counting Sort"
+                             : size >= SORTLIB_AUTO_RADIX_MIN_SIZE ? "Radix Sort" : "Quick Sort";
+        printf("%-14s Auto picks %s\n\n", "", choice);
+    }
+    
+    free(distinctCounts);
+    free(distinctValues);
+    free(arrCopy);
+    free(values);
 }
 
 void performanceTesting() {
@@ -914,13 +3262,13 @@ void performanceTesting() {
     printHeader("PERFORMANCE TESTING MODE");
     printf("(No visualization - pure performance measurement)\n\n");
     
-    printf("Performance testing is available for Array/Vector sorting only.\n");
-    printf("Matrix and Linked List performance testing will be added in future versions.\n\n");
+    printf("Performance testing covers Array/Vector sorting and Matrix string sorting.\n");
+    printf("Linked List performance testing will be added in future versions.\n\n");
     
     // Get test parameters
-    unsigned int size;
+    size_t size;
     printf("Enter array size for performance testing: ");
-    scanf("%u", &size);
+    scanf("%zu", &size);
     if (size == 0) {
         printf("Invalid size!\n");
         return;
@@ -934,119 +3282,303 @@ void performanceTesting() {
     printf("Choose testing mode:\n");
     printf("1. Test specific algorithm\n");
     printf("2. Test all algorithms\n");
+    printf("3. Incremental insertion (batched appends)\n");
+    printf("4. Parallel scaling (sample sort / radix sort / counting sort)\n");
+    printf("5. String sorting (matrix, size = number of strings)\n");
+    printf("6. Order specialization gain (runtime check vs specialized kernels)\n");
+    printf("7. Heap arity (binary vs 4-ary vs 8-ary heap sort and priority queue)\n");
+    printf("8. Key type throughput (int32/int64/uint32/uint64/float/double engines)\n");
+    printf("9. Tiny array batches (size = number of arrays)\n");
+    printf("10. Huge pages and first-touch placement (radix / sample sort, dTLB misses)\n");
+    printf("11. Key range (counting sort vs quick sort, auto selection)\n");
+    printf("12. Stable sort under a memory budget (block merge vs merge sort)\n");
     printf("Choice: ");
     int testChoice;
     scanf("%d", &testChoice);
     
-    printf("Generating random array of size %u...\n", size);
+    if (testChoice == 5) {
+        beginBenchmarkRun();
+        if (size > UINT_MAX) {
+            printf("Invalid size!\n");
+            return;
+        }
+        stringSortBenchmark((unsigned int)size, ascending);
+        return;
+    }
+    if (testChoice == 8) {
+        beginBenchmarkRun();
+        typeThroughputBenchmark(size, ascending);
+        return;
+    }
+    if (testChoice == 9) {
+        beginBenchmarkRun();
+        tinyArrayBenchmark(size, ascending);
+        return;
+    }
+    if (testChoice == 10) {
+        beginBenchmarkRun();
+        hugePageBenchmark(size, ascending);
+        return;
+    }
+    if (testChoice == 11) {
+        beginBenchmarkRun();
+        keyRangeBenchmark(size, ascending);
+        return;
+    }
+    
+    beginBenchmarkRun();
+    
+    printf("Generating random array of size %zu...\n", size);
     int* arr = generateRandomArray(size);
+    
+    if (testChoice == 3) {
+        incrementalBenchmark(arr, size, ascending);
+        free(arr);
+        return;
+    }
+    if (testChoice == 4) {
+        parallelScalingBenchmark(arr, size, ascending);
+        free(arr);
+        return;
+    }
+    if (testChoice == 6) {
+        orderSpecializationBenchmark(arr, size, ascending);
+        free(arr);
+        return;
+    }
+    if (testChoice == 7) {
+        heapArityBenchmark(arr, size, ascending);
+        free(arr);
+        return;
+    }
+    if (testChoice == 12) {
+        blockMergeBenchmark(arr, size, ascending);
+        free(arr);
+        return;
+    }
+    
+    unsigned int repetitions;
+    printf("Repetitions per algorithm (2+ enables regression comparison): ");
+    scanf("%u", &repetitions);
+    if (repetitions == 0) repetitions = 1;
+    
+    // Algorithms whose estimated scratch exceeds the budget are skipped;
+    // measured peaks above it are flagged
+    size_t budgetKb;
+    printf("Memory budget for scratch space in KB (0 = unlimited): ");
+    scanf("%zu", &budgetKb);
+    
     int* arrCopy = malloc(size * sizeof(int));
-    SortStats stats;
+    if (!arrCopy) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
     
+    int first = 0, last = NUM_ARRAY_ALGORITHMS - 1;
     if (testChoice == 1) {
         // Test specific algorithm
         printAlgorithmMenu("Array");
         int algChoice;
         scanf("%d", &algChoice);
-        
-        printf("\nTesting Array/Vector sorting algorithm...\n");
-        printf("Size: %u, Order: %s\n\n", size, ascending ? "Ascending" : "Descending");
-        printf("%-15s %-15s %-20s %-20s\n", "Algorithm", "Time (ms)", "Comparisons", "Swaps");
-        printf("----------------------------------------------------------------\n");
-        
-        switch (algChoice) {
-            case 1:
-                memcpy(arrCopy, arr, size * sizeof(int));
-                bubbleSortArray(arrCopy, size, ascending, &stats, false);
-                printf("%-15s %-15.6f %-20llu %-20llu\n", "Bubble Sort", stats.execution_time_ms, stats.comparisons, stats.swaps);
-                break;
-            case 2:
-                memcpy(arrCopy, arr, size * sizeof(int));
-                selectionSortArray(arrCopy, size, ascending, &stats, false);
-                printf("%-15s %-15.6f %-20llu %-20llu\n", "Selection Sort", stats.execution_time_ms, stats.comparisons, stats.swaps);
-                break;
-            case 3:
-                memcpy(arrCopy, arr, size * sizeof(int));
-                insertionSortArray(arrCopy, size, ascending, &stats, false);
-                printf("%-15s %-15.6f %-20llu %-20llu\n", "Insertion Sort", stats.execution_time_ms, stats.comparisons, stats.swaps);
-                break;
-            case 4:
-                memcpy(arrCopy, arr, size * sizeof(int));
-                stats.comparisons = 0;
-                stats.swaps = 0;
-                double startTime = getTimeMs();
-                mergeSortArray(arrCopy, 0, size - 1, ascending, &stats, false);
-                stats.execution_time_ms = getTimeMs() - startTime;
-                printf("%-15s %-15.6f %-20llu %-20llu\n", "Merge Sort", stats.execution_time_ms, stats.comparisons, stats.swaps);
-                break;
-            case 5:
-                memcpy(arrCopy, arr, size * sizeof(int));
-                stats.comparisons = 0;
-                stats.swaps = 0;
-                startTime = getTimeMs();
-                quickSortArray(arrCopy, 0, size - 1, ascending, &stats, false);
-                stats.execution_time_ms = getTimeMs() - startTime;
-                printf("%-15s %-15.6f %-20llu %-20llu\n", "Quick Sort", stats.execution_time_ms, stats.comparisons, stats.swaps);
-                break;
-            case 6:
-                memcpy(arrCopy, arr, size * sizeof(int));
-                combSortArray(arrCopy, size, ascending, &stats, false);
-                printf("%-15s %-15.6f %-20llu %-20llu\n", "Comb Sort", stats.execution_time_ms, stats.comparisons, stats.swaps);
-                break;
-            default:
-                printf("Invalid choice!\n");
-                free(arrCopy);
-                free(arr);
-                return;
+        if (algChoice < 1 || algChoice > NUM_ARRAY_ALGORITHMS) {
+            printf("Invalid choice!\n");
+            free(arrCopy);
+            free(arr);
+            return;
         }
+        first = last = algChoice - 1;
+        printf("\nTesting Array/Vector sorting algorithm...\n");
     } else {
-        // Test all algorithms
         printf("\nTesting all Array/Vector sorting algorithms...\n");
-        printf("Size: %u, Order: %s\n\n", size, ascending ? "Ascending" : "Descending");
-        printf("%-15s %-15s %-20s %-20s\n", "Algorithm", "Time (ms)", "Comparisons", "Swaps");
-        printf("----------------------------------------------------------------\n");
-        
-        // Test each algorithm
-        const char* algorithms[] = {"Bubble Sort", "Selection Sort", "Insertion Sort", "Merge Sort", "Quick Sort", "Comb Sort"};
+    }
+    
+    printf("Size: %zu, Order: %s, Repetitions: %u\n\n", size, ascending ? "Ascending" : "Descending", repetitions);
+    printf("%-15s %-15s %-15s %-15s %-15s %-8s %-15s\n", "Algorithm",
+           repetitions > 1 ? "Mean time (ms)" : "Time (ms)", "Comparisons", "Swaps", "Peak heap (KB)",
+           "Allocs", "Peak RSS (KB)");
+    printf("---------------------------------------------------------------------------------------------------\n");
+    
+    for (int i = first; i <= last; i++) {
+        size_t estimateKb = (sortlib_arrayAlgorithms[i].scratchBytes(size) + 1023) / 1024;
+        if (budgetKb > 0 && estimateKb > budgetKb) {
+            printf("%-15s SKIPPED: estimated %zu KB of scratch exceeds the budget\n", sortlib_arrayAlgorithms[i].name,
+                   estimateKb);
+            continue;
+        }
         
-        for (int i = 0; i < 6; i++) {
+        sortlib_Stats stats;
+        double totalTime = 0.0;
+        for (unsigned int r = 0; r < repetitions; r++) {
             memcpy(arrCopy, arr, size * sizeof(int));
+            beginMemoryMeasurement();
+            sortlib_arrayAlgorithms[i].sort(arrCopy, size, ascending, &stats, NULL);
+            endMemoryMeasurement(&stats);
+            recordBenchmarkResult(sortlib_arrayAlgorithms[i].name, "random", size, 1, ascending, &stats);
+            totalTime += stats.execution_time_ms;
+        }
+        
+        size_t peakKb = (stats.peakHeapBytes + 1023) / 1024;
+        printf("%-15s %-15.6f %-15llu %-15llu %-15zu %-8llu %-15ld%s\n", sortlib_arrayAlgorithms[i].name,
+               totalTime / repetitions, stats.comparisons, stats.swaps, peakKb, stats.allocations,
+               stats.peakRssKb, budgetKb > 0 && peakKb > budgetKb ? " OVER BUDGET" : "");
+    }
+    
+    free(arrCopy);
+    free(arr);
+}
+
+void verificationMode() {
+    clearScreen();
+    printHeader("VERIFICATION MODE");
+    printf("Runs every engine on random and adversarial inputs and checks the int\n");
+    printf("order, permutation (multiset hash) and agreement between engines,\n");
+    printf("the typed, batch, container, queue, string and list engines, and the\n");
+    printf("stability of the merge sorts, sortlib_sortInts, the list sorts and table sort.\n\n");
+    
+    size_t maxSize;
+    printf("Largest array size (e.g. 100000000): ");
+    scanf("%zu", &maxSize);
+    if (maxSize == 0 || maxSize > INT_MAX) {
+        printf("Invalid size!\n");
+        return;
+    }
+    
+    printOrderMenu();
+    int order;
+    scanf("%d", &order);
+    bool ascending = (order == 1);
+    
+    unsigned int threads = promptThreadCount();
+    
+    unsigned long long seedInput;
+    printf("Random seed (0 = from the clock): ");
+    scanf("%llu", &seedInput);
+    uint64_t seed = seedInput ? seedInput : (uint64_t)time(NULL);
+    
+    // Edge sizes around the insertion sort cutoff, then powers of ten
+    size_t sizes[32];
+    size_t numSizes = 0;
+    const size_t edgeSizes[] = {0, 1, 2, 3, 31, 32, 33, 100, 1000};
+    for (size_t i = 0; i < sizeof(edgeSizes) / sizeof(edgeSizes[0]); i++) {
+        if (edgeSizes[i] < maxSize) sizes[numSizes++] = edgeSizes[i];
+    }
+    for (size_t size = 10000; size < maxSize; size *= 10) sizes[numSizes++] = size;
+    sizes[numSizes++] = maxSize;
+    
+    int* values = malloc(maxSize * sizeof(int));
+    void* work = malloc(maxSize * sizeof(uint64_t));  // Also holds the typed engines' keys
+    char* strings = malloc((maxSize < VERIFY_STRING_LIMIT ? maxSize : VERIFY_STRING_LIMIT) * VERIFY_STRING_WIDTH);
+    if (!values || !work || !strings) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    int* arrCopy = work;
+    
+    beginBenchmarkRun();
+    verifyPool = startThreadPool(threads);
+    printf("\nSeed: %llu, Order: %s, Threads: %u, Engines: %zu, Distributions: %zu\n",
+           (unsigned long long)seed, ascending ? "Ascending" : "Descending", threads,
+           NUM_VERIFY_ENGINES, NUM_VERIFY_DISTRIBUTIONS);
+    printf("Quadratic engines are skipped above %d elements, string and list sorts above %d,\n",
+           VERIFY_QUADRATIC_LIMIT, VERIFY_STRING_LIMIT);
+    printf("stability checks above %d\n\n", VERIFY_STABILITY_LIMIT);
+    printf("%-16s %-12s %-40s %-15s %-12s %s\n", "Distribution", "Size", "Engine", "Time (ms)", "M elem/s",
+           "Result");
+    printf("---------------------------------------------------------------------------------------------------"
+           "------------\n");
+    
+    unsigned long long runs = 0, failures = 0, skipped = 0;
+    char failure[MAX_FIELD_LENGTH];
+    
+    for (size_t s = 0; s < numSizes; s++) {
+        size_t size = sizes[s];
+        bool report = (size == maxSize);
+        
+        for (size_t d = 0; d < NUM_VERIFY_DISTRIBUTIONS; d++) {
+            const VerifyDistribution* dist = &verifyDistributions[d];
+            uint64_t state = seed ^ mixBits(size * NUM_VERIFY_DISTRIBUTIONS + d);
+            dist->generate(values, size, &state);
+            VerifyCase vc = {dist->name, values, size, ascending, report, multisetHash(values, size), NULL, 0, 0, 0, 0};
+            
+            for (size_t e = 0; e < NUM_VERIFY_ENGINES; e++) {
+                const VerifyEngine* engine = &verifyEngines[e];
+                if (size > VERIFY_QUADRATIC_LIMIT && engine->cost == VERIFY_QUADRATIC) {
+                    skipCheck(&vc, engine->name, "quadratic");
+                    continue;
+                }
+                
+                memcpy(arrCopy, values, size * sizeof(int));
+                sortlib_Stats stats = {0};
+                double startTime = sortlib_timeMs();
+                engine->sort(arrCopy, size, ascending, &stats, NULL);
+                double elapsed = sortlib_timeMs() - startTime;
+                
+                failure[0] = '\0';
+                checkIntOutput(&vc, engine->name, arrCopy, failure, sizeof(failure));
+                reportCheck(&vc, engine->name, elapsed, failure);
+                if (report) {
+                    stats.execution_time_ms = elapsed;
+                    recordBenchmarkResult(engine->name, dist->name, size, engine->usesPool ? threads : 1,
+                                          ascending, &stats);
+                }
+            }
             
-            switch (i) {
-                case 0:
-                    bubbleSortArray(arrCopy, size, ascending, &stats, false);
-                    break;
-                case 1:
-                    selectionSortArray(arrCopy, size, ascending, &stats, false);
-                    break;
-                case 2:
-                    insertionSortArray(arrCopy, size, ascending, &stats, false);
-                    break;
-                case 3:
-                    stats.comparisons = 0;
-                    stats.swaps = 0;
-                    double startTime = getTimeMs();
-                    mergeSortArray(arrCopy, 0, size - 1, ascending, &stats, false);
-                    stats.execution_time_ms = getTimeMs() - startTime;
-                    break;
-                case 4:
-                    stats.comparisons = 0;
-                    stats.swaps = 0;
-                    startTime = getTimeMs();
-                    quickSortArray(arrCopy, 0, size - 1, ascending, &stats, false);
-                    stats.execution_time_ms = getTimeMs() - startTime;
-                    break;
-                case 5:
-                    combSortArray(arrCopy, size, ascending, &stats, false);
-                    break;
+            verifyTypedInt64(&vc, work);
+            verifyTypedUInt32(&vc, work);
+            verifyTypedUInt64(&vc, work);
+            verifyTypedFloat(&vc, work);
+            verifyTypedDouble(&vc, work);
+            verifyBatchSorts(&vc, arrCopy);
+            verifyContainers(&vc, arrCopy);
+            verifyPriorityQueues(&vc, arrCopy);
+            if (size <= VERIFY_STRING_LIMIT) {
+                for (size_t i = 0; i < size; i++) formatVerifyString(values[i], strings + i * VERIFY_STRING_WIDTH);
+                verifyStringSorts(&vc, strings);
+                verifyListSorts(&vc, strings);
+            } else {
+                skipCheck(&vc, "String and list sorts", "string limit");
             }
+            verifyStability(&vc, arrCopy);
             
-            printf("%-15s %-15.6f %-20llu %-20llu\n", algorithms[i], stats.execution_time_ms, stats.comparisons, stats.swaps);
+            runs += vc.passed + vc.failed;
+            failures += vc.failed;
+            skipped += vc.skipped;
+            if (!report) {
+                printf("%-16s %-12zu %u passed, %u failed, %u skipped\n", dist->name, size, vc.passed, vc.failed,
+                       vc.skipped);
+            }
         }
+        if (report) printf("\n");
     }
     
-    free(arrCopy);
-    free(arr);
+    sortlib_destroyThreadPool(verifyPool);
+    verifyPool = NULL;
+    free(strings);
+    free(work);
+    free(values);
+    
+    // Skipped checks ran at the smaller sizes, so only failures decide the verdict
+    printf("\n%llu checks, %llu failed: %s\n", runs, failures, failures ? "FAILURES FOUND" : "ALL ENGINES VERIFIED");
+    if (skipped) {
+        printf("%llu checks skipped above their size limits (verified up to them)\n", skipped);
+    }
+}
+
+void traceReplay() {
+    clearScreen();
+    printHeader("STEP TRACE REPLAY");
+    
+    char path[SORTLIB_STRING_LENGTH];
+    unsigned long long stride;
+    printf("Enter trace file path: ");
+    scanf("%99s", path);
+    printf("Show every Nth step (1 = all): ");
+    scanf("%llu", &stride);
+    if (stride == 0) {
+        stride = 1;
+    }
+    
+    replayStepTrace(path, stride);
 }
 
 // ============================================================================
@@ -1055,6 +3587,7 @@ void performanceTesting() {
 
 int main() {
     int choice;
+    setlocale(LC_COLLATE, "");
     
     do {
         printMainMenu();
@@ -1074,18 +3607,30 @@ int main() {
                 performanceTesting();
                 break;
             case 5:
+                compareBenchmarkRuns();
+                break;
+            case 6:
+                traceReplay();
+                break;
+            case 7:
+                tableSorting();
+                break;
+            case 8:
+                verificationMode();
+                break;
+            case 9:
                 printf("Goodbye!\n");
                 break;
             default:
                 printf("Invalid choice! Please try again.\n");
         }
         
-        if (choice != 5) {
+        if (choice != 9) {
             printf("\nPress Enter to continue...");
             getchar();
             getchar();
         }
-    } while (choice != 5);
+    } while (choice != 9);
     
     return 0;
 }
@@ -0,0 +1,3678 @@
+
+
+#include "sortlib.h"
+#include "sortlib_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/time.h>
+#include <limits.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#define INSERTION_SORT_THRESHOLD 32  // Batches this small are sorted by insertion
+#define NINTHER_THRESHOLD 128        // Larger quick sort ranges take the ninther as pivot
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define SAMPLE_OVERSAMPLING 32       // Samples drawn per sample-sort bucket
+#define BUCKETS_PER_THREAD 4         // Extra buckets for dynamic load balancing
+#define CACHE_LINE_SIZE 64
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)(address))
+#endif
+
+// ============================================================================
+// DATA STRUCTURES
+// ============================================================================
+
+typedef struct {
+    sortlib_ThreadPool* pool;
+    unsigned int threadId;
+} PoolWorkerArgs;
+
+struct sortlib_ThreadPool {
+    pthread_t threads[SORTLIB_MAX_THREADS];
+    PoolWorkerArgs workerArgs[SORTLIB_MAX_THREADS];
+    unsigned int numThreads;
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+    sortlib_PoolTask task;
+    void* ctx;
+    unsigned long generation;
+    unsigned int pending;
+    bool shutdown;
+    sortlib_PageMode scratchPages;           // Mapping of the parallel engines' large scratch blocks
+};
+
+// ============================================================================
+// UTILITY FUNCTIONS
+// ============================================================================
+
+double sortlib_timeMs(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec * 1000.0) + (tv.tv_usec / 1000.0);
+}
+
+// ============================================================================
+// SWAP FUNCTIONS
+// ============================================================================
+
+static void swap(int* a, int* b) {
+    int temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+static void swapStrings(char* a, char* b) {
+    char temp[SORTLIB_STRING_LENGTH];
+    strcpy(temp, a);
+    strcpy(a, b);
+    strcpy(b, temp);
+}
+
+// ============================================================================
+// LARGE PAGE BUFFERS
+// ============================================================================
+
+const char* sortlib_pageModeName(sortlib_PageMode mode) {
+    switch (mode) {
+        case SORTLIB_PAGES_TRANSPARENT_HUGE: return "THP (madvise)";
+        case SORTLIB_PAGES_EXPLICIT_HUGE: return "Explicit 2 MB";
+        default: return "4 KB pages";
+    }
+}
+
+static size_t largeBufferLength(size_t bytes) {
+    return (bytes + SORTLIB_HUGE_PAGE_SIZE - 1) / SORTLIB_HUGE_PAGE_SIZE * SORTLIB_HUGE_PAGE_SIZE;
+}
+
+// Maps bytes of zeroed memory aligned to SORTLIB_HUGE_PAGE_SIZE. Explicit huge pages
+// need pages reserved in /proc/sys/vm/nr_hugepages; without them the mapping
+// falls back to transparent huge pages. *used (may be NULL) receives the mode
+// actually applied. Outside Linux this is plain malloc.
+void* sortlib_allocLargeBuffer(size_t bytes, sortlib_PageMode mode, sortlib_PageMode* used) {
+#ifdef __linux__
+    size_t length = largeBufferLength(bytes ? bytes : 1);
+    
+    if (mode == SORTLIB_PAGES_EXPLICIT_HUGE) {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+        flags |= 21 << MAP_HUGE_SHIFT;  // 2 MB pages
+#endif
+        void* mapped = mmap(NULL, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (mapped != MAP_FAILED) {
+            if (used) *used = SORTLIB_PAGES_EXPLICIT_HUGE;
+            return mapped;
+        }
+        mode = SORTLIB_PAGES_TRANSPARENT_HUGE;
+    }
+    
+    // Over-map by one huge page and trim, so the buffer starts on a huge page
+    // boundary and the kernel can back all of it with huge pages
+    char* mapped = mmap(NULL, length + SORTLIB_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) return NULL;
+    uintptr_t start = ((uintptr_t)mapped + SORTLIB_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(SORTLIB_HUGE_PAGE_SIZE - 1);
+    char* aligned = (char*)start;
+    if (aligned > mapped) {
+        munmap(mapped, aligned - mapped);
+    }
+    size_t tail = (mapped + length + SORTLIB_HUGE_PAGE_SIZE) - (aligned + length);
+    if (tail > 0) {
+        munmap(aligned + length, tail);
+    }
+    
+#ifdef MADV_HUGEPAGE
+    if (mode == SORTLIB_PAGES_TRANSPARENT_HUGE && madvise(aligned, length, MADV_HUGEPAGE) != 0) {
+        mode = SORTLIB_PAGES_DEFAULT;
+    }
+#else
+    mode = SORTLIB_PAGES_DEFAULT;
+#endif
+    if (used) *used = mode;
+    return aligned;
+#else
+    if (used) *used = SORTLIB_PAGES_DEFAULT;
+    (void)mode;
+    return calloc(bytes ? bytes : 1, 1);
+#endif
+}
+
+void sortlib_freeLargeBuffer(void* ptr, size_t bytes) {
+    if (!ptr) return;
+#ifdef __linux__
+    munmap(ptr, largeBufferLength(bytes ? bytes : 1));
+#else
+    (void)bytes;
+    free(ptr);
+#endif
+}
+
+// ============================================================================
+// MEMORY TRACKING
+// ============================================================================
+
+// Scratch memory of the sort engines goes through trackedMalloc/trackedFree.
+// Each block carries a header with its size so frees can be accounted; the
+// counters are atomic because the parallel engines allocate from workers.
+typedef union {
+    struct {
+        size_t size;
+        bool largeBuffer;            // Mapped with sortlib_allocLargeBuffer
+    } block;
+    max_align_t alignment;
+} AllocationHeader;
+
+static atomic_ullong trackedBytesAllocated;
+static atomic_ullong trackedAllocationCount;
+static atomic_size_t trackedLiveBytes;
+static atomic_size_t trackedPeakBytes;
+static size_t measurementBaseline;
+
+// For memory whose size is known but that cannot carry a header
+// (aligned or caller-owned blocks)
+static void recordAllocation(size_t bytes) {
+    atomic_fetch_add_explicit(&trackedBytesAllocated, bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&trackedAllocationCount, 1, memory_order_relaxed);
+    size_t live = atomic_fetch_add_explicit(&trackedLiveBytes, bytes, memory_order_relaxed) + bytes;
+    
+    size_t peak = atomic_load_explicit(&trackedPeakBytes, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&trackedPeakBytes, &peak, live,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void recordRelease(size_t bytes) {
+    atomic_fetch_sub_explicit(&trackedLiveBytes, bytes, memory_order_relaxed);
+}
+
+// Blocks of at least SORTLIB_LARGE_BUFFER_THRESHOLD bytes are mapped with pages
+// (see sortlib_allocLargeBuffer) unless that is SORTLIB_PAGES_DEFAULT
+static void* trackedMallocPages(size_t bytes, sortlib_PageMode pages) {
+    bool large = pages != SORTLIB_PAGES_DEFAULT && bytes >= SORTLIB_LARGE_BUFFER_THRESHOLD;
+    AllocationHeader* header = large
+        ? sortlib_allocLargeBuffer(sizeof(AllocationHeader) + bytes, pages, NULL)
+        : malloc(sizeof(AllocationHeader) + bytes);
+    if (!header) return NULL;
+    header->block.size = bytes;
+    header->block.largeBuffer = large;
+    recordAllocation(bytes);
+    return header + 1;
+}
+
+static void* trackedMalloc(size_t bytes) {
+    return trackedMallocPages(bytes, SORTLIB_PAGES_DEFAULT);
+}
+
+static void trackedFree(void* ptr) {
+    if (!ptr) return;
+    AllocationHeader* header = (AllocationHeader*)ptr - 1;
+    recordRelease(header->block.size);
+    if (header->block.largeBuffer) {
+        sortlib_freeLargeBuffer(header, sizeof(AllocationHeader) + header->block.size);
+    } else {
+        free(header);
+    }
+}
+
+static void* trackedRealloc(void* ptr, size_t bytes) {
+    if (!ptr) return trackedMalloc(bytes);
+    AllocationHeader* header = (AllocationHeader*)ptr - 1;
+    size_t oldBytes = header->block.size;
+    
+    // Mapped blocks are moved by hand
+    if (header->block.largeBuffer) {
+        void* moved = trackedMalloc(bytes);
+        if (!moved) return NULL;
+        memcpy(moved, ptr, oldBytes < bytes ? oldBytes : bytes);
+        trackedFree(ptr);
+        return moved;
+    }
+    
+    AllocationHeader* grown = realloc(header, sizeof(AllocationHeader) + bytes);
+    if (!grown) return NULL;
+    grown->block.size = bytes;
+    recordRelease(oldBytes);
+    recordAllocation(bytes);
+    return grown + 1;
+}
+
+// Brackets one measured sort in the benchmark harness; only the scratch
+// counters, the harness measures the peak RSS itself
+void sortlib_beginScratchMeasurement(void) {
+    atomic_store(&trackedBytesAllocated, 0);
+    atomic_store(&trackedAllocationCount, 0);
+    measurementBaseline = atomic_load(&trackedLiveBytes);
+    atomic_store(&trackedPeakBytes, measurementBaseline);
+}
+
+void sortlib_endScratchMeasurement(sortlib_Stats* stats) {
+    stats->bytesAllocated = atomic_load(&trackedBytesAllocated);
+    stats->allocations = atomic_load(&trackedAllocationCount);
+    stats->peakHeapBytes = atomic_load(&trackedPeakBytes) - measurementBaseline;
+}
+
+// ============================================================================
+// THREAD POOL
+// ============================================================================
+
+static void* poolWorker(void* arg) {
+    PoolWorkerArgs* args = arg;
+    sortlib_ThreadPool* pool = args->pool;
+    unsigned long seen = 0;
+    
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->shutdown && pool->generation == seen) {
+            pthread_cond_wait(&pool->workReady, &pool->lock);
+        }
+        if (pool->shutdown) break;
+        seen = pool->generation;
+        sortlib_PoolTask task = pool->task;
+        void* ctx = pool->ctx;
+        pthread_mutex_unlock(&pool->lock);
+        
+        task(ctx, args->threadId);
+        
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->workDone);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+sortlib_ThreadPool* sortlib_createThreadPool(unsigned int numThreads, sortlib_PageMode scratchPages) {
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > SORTLIB_MAX_THREADS) numThreads = SORTLIB_MAX_THREADS;
+    
+    sortlib_ThreadPool* pool = malloc(sizeof(sortlib_ThreadPool));
+    if (!pool) return NULL;
+    pool->numThreads = numThreads;
+    pool->task = NULL;
+    pool->ctx = NULL;
+    pool->generation = 0;
+    pool->pending = 0;
+    pool->shutdown = false;
+    pool->scratchPages = scratchPages;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workReady, NULL);
+    pthread_cond_init(&pool->workDone, NULL);
+    
+    for (unsigned int t = 1; t < numThreads; t++) {
+        PoolWorkerArgs* args = &pool->workerArgs[t];
+        args->pool = pool;
+        args->threadId = t;
+        if (pthread_create(&pool->threads[t], NULL, poolWorker, args) != 0) {
+            // Stop the workers already running
+            pool->numThreads = t;
+            sortlib_destroyThreadPool(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+// Runs task(ctx, id) once on every thread of the pool and waits for all of them
+void sortlib_runThreadPool(sortlib_ThreadPool* pool, sortlib_PoolTask task, void* ctx) {
+    if (pool->numThreads > 1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->task = task;
+        pool->ctx = ctx;
+        pool->pending = pool->numThreads - 1;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->workReady);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    
+    task(ctx, 0);
+    
+    if (pool->numThreads > 1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->pending > 0) {
+            pthread_cond_wait(&pool->workDone, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+unsigned int sortlib_threadPoolSize(const sortlib_ThreadPool* pool) {
+    return pool->numThreads;
+}
+
+void sortlib_destroyThreadPool(sortlib_ThreadPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->workReady);
+    pthread_mutex_unlock(&pool->lock);
+    
+    for (unsigned int t = 1; t < pool->numThreads; t++) {
+        pthread_join(pool->threads[t], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->workReady);
+    pthread_cond_destroy(&pool->workDone);
+    free(pool);
+}
+
+// Splits [0, total) into numThreads contiguous chunks
+static void threadChunk(size_t total, unsigned int numThreads, unsigned int threadId, size_t* begin, size_t* end) {
+    *begin = total * threadId / numThreads;
+    *end = total * (threadId + 1) / numThreads;
+}
+
+typedef struct {
+    char* base;
+    size_t pages;
+    size_t pageSize;
+    unsigned int numThreads;
+} FirstTouchContext;
+
+static void firstTouchTask(void* arg, unsigned int threadId) {
+    FirstTouchContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->pages, ctx->numThreads, threadId, &begin, &end);
+    for (size_t page = begin; page < end; page++) {
+        ctx->base[page * ctx->pageSize] = 0;
+    }
+}
+
+// Faults in a fresh buffer from the pool's threads, each writing the chunk
+// threadChunk() will also hand it when sorting, so the kernel's first-touch
+// policy places every chunk on the NUMA node of the thread that works on it
+void sortlib_firstTouchBuffer(void* buffer, size_t bytes, sortlib_ThreadPool* pool) {
+    long pageSize = sysconf(_SC_PAGESIZE);
+    FirstTouchContext ctx;
+    ctx.base = buffer;
+    ctx.pageSize = pageSize > 0 ? (size_t)pageSize : 4096;
+    ctx.pages = (bytes + ctx.pageSize - 1) / ctx.pageSize;
+    ctx.numThreads = pool->numThreads;
+    sortlib_runThreadPool(pool, firstTouchTask, &ctx);
+}
+
+// ============================================================================
+// STEP OBSERVER
+// ============================================================================
+
+// Engines never print. Given an observer (NULL for none) they describe their
+// progress to it: snapshots through onStep, and the single comparisons and
+// moves of the array engines through onOperation (used to record step traces).
+// The observer is a parameter, so concurrent sorts can report to different ones.
+#define SHOW_STEP (observer != NULL && observer->onStep != NULL)
+#define REPORT_STEP(...) observer->onStep(observer->context, &(sortlib_Step){__VA_ARGS__})
+#define REPORT_OPERATION(op, first, second)                                                         \
+    do {                                                                                            \
+        if (observer != NULL && observer->onOperation != NULL) {                                    \
+            observer->onOperation(observer->context, (op), (first), (second));                      \
+        }                                                                                           \
+    } while (0)
+#define TRACE_COMPARE(i, j) REPORT_OPERATION(SORTLIB_OP_COMPARE, (i), (j))
+#define TRACE_SWAP(i, j) REPORT_OPERATION(SORTLIB_OP_SWAP, (i), (j))
+#define TRACE_WRITE(k, v) REPORT_OPERATION(SORTLIB_OP_WRITE, (k), (uint64_t)(int64_t)(v))
+
+// ============================================================================
+// SORTING ALGORITHMS - ARRAYS
+// ============================================================================
+
+// Every engine body is written once as a generator macro and instantiated per
+// sort order. PRECEDES(a, b) is true when a must come strictly before b, so the
+// ascending and descending kernels carry a single comparison in their inner
+// loops; the *RuntimeOrder variants keep the old per-comparison order check and
+// exist only so the benchmark can measure the difference.
+#define ASCENDING_PRECEDES(a, b) ((a) < (b))
+#define DESCENDING_PRECEDES(a, b) ((a) > (b))
+#define RUNTIME_PRECEDES(a, b) ((ascending && (a) < (b)) || (!ascending && (a) > (b)))
+
+#define STRING_ASCENDING_PRECEDES(a, b) (strcmp((a), (b)) < 0)
+#define STRING_DESCENDING_PRECEDES(a, b) (strcmp((a), (b)) > 0)
+#define STRING_RUNTIME_PRECEDES(a, b) ((ascending && strcmp((a), (b)) < 0) || (!ascending && strcmp((a), (b)) > 0))
+
+// Generates the Ascending, Descending and RuntimeOrder kernels of an engine
+#define INSTANTIATE_ORDERS(GENERATOR)                                                              \
+    GENERATOR(Ascending, ASCENDING_PRECEDES)                                                        \
+    GENERATOR(Descending, DESCENDING_PRECEDES)                                                      \
+    GENERATOR(RuntimeOrder, RUNTIME_PRECEDES)
+
+#define INSTANTIATE_STRING_ORDERS(GENERATOR)                                                       \
+    GENERATOR(Ascending, STRING_ASCENDING_PRECEDES)                                                 \
+    GENERATOR(Descending, STRING_DESCENDING_PRECEDES)                                               \
+    GENERATOR(RuntimeOrder, STRING_RUNTIME_PRECEDES)
+
+// Public entry point sortlib_NAME: picks the kernel once instead of on every
+// comparison. The HELPER variant is the same for file-local functions.
+#define ORDER_DISPATCH_BODY(NAME, ARGS)                                                             \
+    {                                                                                               \
+        if (ascending) {                                                                            \
+            NAME##Ascending ARGS;                                                                   \
+        } else {                                                                                    \
+            NAME##Descending ARGS;                                                                  \
+        }                                                                                           \
+    }
+#define DEFINE_ORDER_DISPATCH(NAME, PARAMS, ARGS)                                                  \
+    void sortlib_##NAME PARAMS ORDER_DISPATCH_BODY(NAME, ARGS)
+#define DEFINE_HELPER_ORDER_DISPATCH(NAME, PARAMS, ARGS)                                           \
+    static void NAME PARAMS ORDER_DISPATCH_BODY(NAME, ARGS)
+
+#define ARRAY_SORT_PARAMS (int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer)
+#define ARRAY_SORT_ARGS (arr, size, ascending, stats, observer)
+
+#define GENERATE_BUBBLE_SORT_ARRAY(SUFFIX, PRECEDES)                                                \
+static void bubbleSortArray##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "BUBBLE SORT", .ascending = ascending, \
+                    .data = arr, .length = size);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    bool swapped;                                                                                   \
+    for (size_t i = 0; i + 1 < size; i++) {                                                         \
+        swapped = false;                                                                            \
+        for (size_t j = 0; j < size - i - 1; j++) {                                                 \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(j, j + 1);                                                                \
+            if (PRECEDES(arr[j + 1], arr[j])) {                                                     \
+                swap(&arr[j], &arr[j + 1]);                                                         \
+                stats->swaps++;                                                                     \
+                swapped = true;                                                                     \
+                TRACE_SWAP(j, j + 1);                                                               \
+                if (SHOW_STEP) {                                                                    \
+                    REPORT_STEP(.kind = SORTLIB_STEP_SWAP, .first = i + 1, .second = stats->swaps,  \
+                                .data = arr, .length = size);                                       \
+                }                                                                                   \
+            }                                                                                       \
+        }                                                                                           \
+        if (!swapped && observer) {                                                                \
+            if (SHOW_STEP) REPORT_STEP(.kind = SORTLIB_STEP_SORTED, .data = arr, .length = size);   \
+            break;                                                                                  \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+#define GENERATE_SELECTION_SORT_ARRAY(SUFFIX, PRECEDES)                                             \
+static void selectionSortArray##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "SELECTION SORT", .ascending = ascending, \
+                    .data = arr, .length = size);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    for (size_t i = 0; i + 1 < size; i++) {                                                         \
+        size_t extreme = i;                                                                         \
+                                                                                                    \
+        for (size_t j = i + 1; j < size; j++) {                                                     \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(j, extreme);                                                              \
+            if (PRECEDES(arr[j], arr[extreme])) {                                                   \
+                extreme = j;                                                                        \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        if (extreme != i) {                                                                         \
+            swap(&arr[extreme], &arr[i]);                                                           \
+            stats->swaps++;                                                                         \
+            TRACE_SWAP(extreme, i);                                                                 \
+            if (SHOW_STEP) {                                                                        \
+                REPORT_STEP(.kind = SORTLIB_STEP_SWAP, .first = i + 1, .second = stats->swaps,      \
+                            .data = arr, .length = size);                                           \
+            }                                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+#define GENERATE_INSERTION_SORT_ARRAY(SUFFIX, PRECEDES)                                             \
+static void insertionSortArray##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "INSERTION SORT", .ascending = ascending, \
+                    .data = arr, .length = size);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    for (size_t i = 1; i < size; i++) {                                                             \
+        int key = arr[i];                                                                           \
+        size_t j = i;                                                                               \
+                                                                                                    \
+        while (j > 0 && PRECEDES(key, arr[j - 1])) {                                                \
+            TRACE_COMPARE(j - 1, j);                                                                \
+            arr[j] = arr[j - 1];                                                                    \
+            TRACE_WRITE(j, arr[j]);                                                                 \
+            j--;                                                                                    \
+            stats->comparisons++;                                                                   \
+            stats->swaps++;                                                                         \
+        }                                                                                           \
+        if (j > 0) TRACE_COMPARE(j - 1, j);                                                         \
+        stats->comparisons++;                                                                       \
+        arr[j] = key;                                                                               \
+        TRACE_WRITE(j, key);                                                                        \
+        if (SHOW_STEP) {                                                                            \
+            REPORT_STEP(.kind = SORTLIB_STEP_INSERT, .first = i, .value = key, .data = arr, .length = size); \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+// Left runs of the bottom-up merge sort never exceed the largest power of two
+// below size; this many ints of scratch cover every merge
+static size_t mergeBufferLength(size_t size) {
+    if (size < 2) return 0;
+    size_t maxRun = 1;
+    while (maxRun < size - maxRun) maxRun *= 2;
+    return maxRun;
+}
+
+// merge##SUFFIX merges arr[left, mid) and arr[mid, right); only the left run is
+// copied out, so buffer needs mid - left slots. Bottom-up passes mean no
+// recursion and one scratch buffer for the whole sort; mergePasses##SUFFIX is
+// that sort on a buffer of mergeBufferLength(size) ints owned by the caller.
+#define GENERATE_MERGE_SORT_ARRAY(SUFFIX, PRECEDES)                                                 \
+static void merge##SUFFIX(int* arr, size_t left, size_t mid, size_t right, int* buffer, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    (void)ascending;                                                                                \
+    size_t n1 = mid - left;                                                                         \
+    memcpy(buffer, arr + left, n1 * sizeof(int));                                                   \
+                                                                                                    \
+    size_t i = 0, j = mid, k = left;                                                                \
+                                                                                                    \
+    while (i < n1 && j < right) {                                                                   \
+        stats->comparisons++;                                                                       \
+        TRACE_COMPARE(k, j);                                                                        \
+        if (!PRECEDES(arr[j], buffer[i])) {                                                         \
+            arr[k] = buffer[i];                                                                     \
+            i++;                                                                                    \
+        } else {                                                                                    \
+            arr[k] = arr[j];                                                                        \
+            j++;                                                                                    \
+            stats->swaps++;                                                                         \
+        }                                                                                           \
+        TRACE_WRITE(k, arr[k]);                                                                     \
+        k++;                                                                                        \
+    }                                                                                               \
+                                                                                                    \
+    /* Whatever is left of the right run is already in place */                                     \
+    while (i < n1) {                                                                                \
+        arr[k] = buffer[i];                                                                         \
+        TRACE_WRITE(k, arr[k]);                                                                     \
+        i++; k++;                                                                                   \
+    }                                                                                               \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_MERGE, .first = left, .second = right - 1, .data = arr, .length = right); \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static void mergePasses##SUFFIX(int* arr, size_t size, int* buffer, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    for (size_t width = 1; width < size; width *= 2) {                                              \
+        for (size_t left = 0; left < size - width; left += 2 * width) {                             \
+            size_t mid = left + width;                                                              \
+            size_t right = (size - mid > width) ? mid + width : size;                               \
+            merge##SUFFIX(arr, left, mid, right, buffer, ascending, stats, observer);              \
+        }                                                                                           \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static void mergeSortArray##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "MERGE SORT", .ascending = ascending,  \
+                    .data = arr, .length = size);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    if (size > 1) {                                                                                 \
+        int* buffer = trackedMalloc(mergeBufferLength(size) * sizeof(int));                         \
+        if (buffer) {                                                                               \
+            mergePasses##SUFFIX(arr, size, buffer, ascending, stats, observer);                    \
+            trackedFree(buffer);                                                                    \
+        } else {                                                                                    \
+            /* No scratch: heap sort in place (ints, so stability is not observable) */             \
+            heapSortRange##SUFFIX(arr, size, SORTLIB_HEAP_ARITY, ascending, stats, NULL);           \
+            traceWrites(arr, 0, size, observer);                                                   \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+// Introsort depth budget: a quick sort range still being partitioned after this
+// many levels has had bad pivots, and is finished by heap sort instead
+static size_t quickSortDepthLimit(size_t size) {
+    size_t depth = 0;
+    while (size > 1) {
+        size >>= 1;
+        depth++;
+    }
+    return 2 * depth;
+}
+
+// Deterministic sampling sequence of the sample sort and the quick sort pivots
+static uint64_t xorshift64(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// pivotIndex##SUFFIX picks the pivot of arr[low, high) without moving anything:
+// the median of first, middle and last element, or above NINTHER_THRESHOLD a
+// ninther (median of three medians of three) of xorshift-drawn positions.
+// Sorted, organ-pipe and periodic inputs cannot line those up on an extreme
+// the way they do fixed positions.
+#define GENERATE_PIVOT_SELECTION(SUFFIX, PRECEDES)                                                  \
+static size_t medianOfThree##SUFFIX(const int* arr, size_t a, size_t b, size_t c, bool ascending, sortlib_Stats* stats) { \
+    (void)ascending;                                                                                \
+    stats->comparisons += 2;                                                                        \
+    if (PRECEDES(arr[a], arr[b])) {                                                                 \
+        if (PRECEDES(arr[b], arr[c])) return b;                                                     \
+        stats->comparisons++;                                                                       \
+        return PRECEDES(arr[a], arr[c]) ? c : a;                                                    \
+    }                                                                                               \
+    if (PRECEDES(arr[a], arr[c])) return a;                                                         \
+    stats->comparisons++;                                                                           \
+    return PRECEDES(arr[b], arr[c]) ? c : b;                                                        \
+}                                                                                                   \
+                                                                                                    \
+static size_t pivotIndex##SUFFIX(const int* arr, size_t low, size_t high, bool ascending, sortlib_Stats* stats) { \
+    size_t size = high - low;                                                                       \
+    if (size <= NINTHER_THRESHOLD) {                                                                \
+        return medianOfThree##SUFFIX(arr, low, low + size / 2, high - 1, ascending, stats);         \
+    }                                                                                               \
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ size;                                                  \
+    size_t medians[3];                                                                              \
+    for (int m = 0; m < 3; m++) {                                                                   \
+        size_t a = low + xorshift64(&state) % size;                                                 \
+        size_t b = low + xorshift64(&state) % size;                                                 \
+        size_t c = low + xorshift64(&state) % size;                                                 \
+        medians[m] = medianOfThree##SUFFIX(arr, a, b, c, ascending, stats);                         \
+    }                                                                                               \
+    return medianOfThree##SUFFIX(arr, medians[0], medians[1], medians[2], ascending, stats);        \
+}
+
+// partitionArray##SUFFIX is a Hoare partition of arr[low, high) around the
+// pivotIndex element and returns the pivot's final index. Both scans stop on
+// keys equal to the pivot, so runs of duplicates are split down the middle
+// instead of all landing on one side.
+// The sort keeps an explicit stack instead of recursing: the larger side is
+// deferred and the smaller one handled first, so at most log2(size) ranges
+// are ever pending. Ranges still unsorted after quickSortDepthLimit levels
+// are heap sorted, which bounds the worst case at O(n log n).
+#define GENERATE_QUICK_SORT_ARRAY(SUFFIX, PRECEDES)                                                 \
+static size_t partitionArray##SUFFIX(int* arr, size_t low, size_t high, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    size_t chosen = pivotIndex##SUFFIX(arr, low, high, ascending, stats);                           \
+    if (chosen != low) {                                                                            \
+        swap(&arr[low], &arr[chosen]);                                                              \
+        TRACE_SWAP(low, chosen);                                                                    \
+        stats->swaps++;                                                                             \
+    }                                                                                               \
+    int pivot = arr[low];                                                                           \
+    size_t i = low, j = high;                                                                       \
+                                                                                                    \
+    while (true) {                                                                                  \
+        while (++i < high) {                                                                        \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(i, low);                                                                  \
+            if (!PRECEDES(arr[i], pivot)) break;                                                    \
+        }                                                                                           \
+        /* Stops at arr[low] at the latest */                                                       \
+        do {                                                                                        \
+            j--;                                                                                    \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(low, j);                                                                  \
+        } while (PRECEDES(pivot, arr[j]));                                                          \
+        if (i >= j) break;                                                                          \
+        swap(&arr[i], &arr[j]);                                                                     \
+        TRACE_SWAP(i, j);                                                                           \
+        stats->swaps++;                                                                             \
+    }                                                                                               \
+    if (j != low) {                                                                                 \
+        swap(&arr[low], &arr[j]);                                                                   \
+        TRACE_SWAP(low, j);                                                                         \
+        stats->swaps++;                                                                             \
+    }                                                                                               \
+    return j;                                                                                       \
+}                                                                                                   \
+                                                                                                    \
+static void quickSortArray##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "QUICK SORT", .ascending = ascending,  \
+                    .data = arr, .length = size);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    size_t stackLow[sizeof(size_t) * CHAR_BIT];                                                     \
+    size_t stackHigh[sizeof(size_t) * CHAR_BIT];                                                    \
+    size_t stackDepth[sizeof(size_t) * CHAR_BIT];                                                   \
+    int top = 0;                                                                                    \
+    size_t low = 0, high = size;                                                                    \
+    size_t depth = quickSortDepthLimit(size);                                                       \
+                                                                                                    \
+    while (true) {                                                                                  \
+        while (high - low > 1) {                                                                    \
+            if (depth == 0) {                                                                       \
+                heapSortRange##SUFFIX(arr + low, high - low, SORTLIB_HEAP_ARITY, ascending, stats, NULL); \
+                traceWrites(arr, low, high, observer);                                             \
+                break;                                                                              \
+            }                                                                                       \
+            depth--;                                                                                \
+            size_t pivot = partitionArray##SUFFIX(arr, low, high, ascending, stats, observer);     \
+                                                                                                    \
+            if (SHOW_STEP) {                                                                        \
+                REPORT_STEP(.kind = SORTLIB_STEP_PIVOT, .data = arr, .length = high);               \
+            }                                                                                       \
+                                                                                                    \
+            if (pivot - low < high - (pivot + 1)) {                                                 \
+                stackLow[top] = pivot + 1;                                                          \
+                stackHigh[top] = high;                                                              \
+                high = pivot;                                                                       \
+            } else {                                                                                \
+                stackLow[top] = low;                                                                \
+                stackHigh[top] = pivot;                                                             \
+                low = pivot + 1;                                                                    \
+            }                                                                                       \
+            stackDepth[top] = depth;                                                                \
+            top++;                                                                                  \
+        }                                                                                           \
+        if (top == 0) break;                                                                        \
+        top--;                                                                                      \
+        low = stackLow[top];                                                                        \
+        high = stackHigh[top];                                                                      \
+        depth = stackDepth[top];                                                                    \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+#define GENERATE_COMB_SORT_ARRAY(SUFFIX, PRECEDES)                                                  \
+static void combSortArray##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "COMB SORT", .ascending = ascending,   \
+                    .data = arr, .length = size);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    size_t gap = size;                                                                              \
+    bool swapped = true;                                                                            \
+                                                                                                    \
+    while (gap > 1 || swapped) {                                                                    \
+        gap = (gap * 10) / 13;                                                                      \
+        if (gap < 1) gap = 1;                                                                       \
+        swapped = false;                                                                            \
+                                                                                                    \
+        for (size_t i = 0; i + gap < size; i++) {                                                   \
+            size_t j = i + gap;                                                                     \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(i, j);                                                                    \
+            if (PRECEDES(arr[j], arr[i])) {                                                         \
+                swap(&arr[i], &arr[j]);                                                             \
+                stats->swaps++;                                                                     \
+                swapped = true;                                                                     \
+                TRACE_SWAP(i, j);                                                                   \
+                if (SHOW_STEP) {                                                                    \
+                    REPORT_STEP(.kind = SORTLIB_STEP_GAP, .first = gap, .data = arr, .length = size); \
+                }                                                                                   \
+            }                                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+// heapSortArrayWithArity##SUFFIX sorts in place on a d-ary heap whose root is
+// the element that belongs last. Sift-down is Floyd's bottom-up variant: the
+// hole walks down along the best children to a leaf (d - 1 comparisons per
+// level, no comparison against the moving element) and the element is then
+// sifted back up, which usually stops after a level or two.
+#define GENERATE_HEAP_SORT_KERNELS(SUFFIX, PRECEDES)                                                \
+static void heapSiftDown##SUFFIX(int* arr, size_t size, size_t hole, size_t top, int value, unsigned int arity, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    (void)ascending;                                                                                \
+    size_t child;                                                                                   \
+    while ((child = arity * hole + 1) < size) {                                                     \
+        size_t end = (size - child > arity) ? child + arity : size;                                 \
+        size_t grandchild = arity * child + 1;                                                      \
+        if (grandchild < size) PREFETCH(&arr[grandchild]);                                          \
+                                                                                                    \
+        size_t best = child;                                                                        \
+        for (size_t c = child + 1; c < end; c++) {                                                  \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(best, c);                                                                 \
+            if (PRECEDES(arr[best], arr[c])) best = c;                                              \
+        }                                                                                           \
+        arr[hole] = arr[best];                                                                      \
+        TRACE_WRITE(hole, arr[hole]);                                                               \
+        hole = best;                                                                                \
+        stats->swaps++;                                                                             \
+    }                                                                                               \
+                                                                                                    \
+    while (hole > top) {                                                                            \
+        size_t parent = (hole - 1) / arity;                                                         \
+        stats->comparisons++;                                                                       \
+        TRACE_COMPARE(parent, hole);                                                                \
+        if (!PRECEDES(arr[parent], value)) break;                                                   \
+        arr[hole] = arr[parent];                                                                    \
+        TRACE_WRITE(hole, arr[hole]);                                                               \
+        hole = parent;                                                                              \
+        stats->swaps++;                                                                             \
+    }                                                                                               \
+    arr[hole] = value;                                                                              \
+    TRACE_WRITE(hole, value);                                                                       \
+}                                                                                                   \
+                                                                                                    \
+/* Adds to stats instead of resetting them; the quick sorts finish ranges                           \
+   that ran out of depth with it, merge sort arrays it gets no scratch for */                       \
+static void heapSortRange##SUFFIX(int* arr, size_t size, unsigned int arity, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    if (size > 1) {                                                                                 \
+        for (size_t i = (size - 2) / arity + 1; i-- > 0; ) {                                        \
+            heapSiftDown##SUFFIX(arr, size, i, i, arr[i], arity, ascending, stats, observer);      \
+        }                                                                                           \
+        if (SHOW_STEP) {                                                                            \
+            REPORT_STEP(.kind = SORTLIB_STEP_HEAP_BUILT, .data = arr, .length = size);              \
+        }                                                                                           \
+                                                                                                    \
+        for (size_t end = size - 1; end > 0; end--) {                                               \
+            int value = arr[end];                                                                   \
+            arr[end] = arr[0];                                                                      \
+            TRACE_WRITE(end, arr[end]);                                                             \
+            stats->swaps++;                                                                         \
+            heapSiftDown##SUFFIX(arr, end, 0, 0, value, arity, ascending, stats, observer);        \
+            if (SHOW_STEP) {                                                                        \
+                REPORT_STEP(.kind = SORTLIB_STEP_EXTRACT, .first = size - end, .data = arr, .length = size); \
+            }                                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+}
+
+#define GENERATE_HEAP_SORT_ARRAY(SUFFIX, PRECEDES)                                                  \
+GENERATE_HEAP_SORT_KERNELS(SUFFIX, PRECEDES)                                                        \
+                                                                                                    \
+static void heapSortArrayWithArity##SUFFIX(int* arr, size_t size, unsigned int arity, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "HEAP SORT", .ascending = ascending,   \
+                    .first = arity, .data = arr, .length = size);                                   \
+    }                                                                                               \
+                                                                                                    \
+    heapSortRange##SUFFIX(arr, size, arity, ascending, stats, observer);                           \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}                                                                                                   \
+                                                                                                    \
+static void heapSortArray##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    heapSortArrayWithArity##SUFFIX(arr, size, SORTLIB_HEAP_ARITY, ascending, stats, observer);      \
+}
+
+// partialSortArray##SUFFIX keeps the k elements that belong first in a heap on
+// arr[0, k) whose root is the one of them that belongs last; every later
+// element that precedes the root replaces it. Heap sort extraction then orders
+// the prefix: O(size log k) comparisons and no scratch.
+#define GENERATE_PARTIAL_SORT_ARRAY(SUFFIX, PRECEDES)                                               \
+static void partialSortArray##SUFFIX(int* arr, size_t size, size_t k, bool ascending, sortlib_Stats* stats) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+    if (k > size) k = size;                                                                         \
+                                                                                                    \
+    if (k > 0) {                                                                                    \
+        for (size_t i = (k > 1) ? (k - 2) / SORTLIB_HEAP_ARITY + 1 : 0; i-- > 0; ) {                \
+            heapSiftDown##SUFFIX(arr, k, i, i, arr[i], SORTLIB_HEAP_ARITY, ascending, stats, NULL); \
+        }                                                                                           \
+                                                                                                    \
+        for (size_t i = k; i < size; i++) {                                                         \
+            stats->comparisons++;                                                                   \
+            if (PRECEDES(arr[i], arr[0])) {                                                         \
+                int value = arr[i];                                                                 \
+                arr[i] = arr[0];                                                                    \
+                stats->swaps++;                                                                     \
+                heapSiftDown##SUFFIX(arr, k, 0, 0, value, SORTLIB_HEAP_ARITY, ascending, stats, NULL); \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        for (size_t end = k - 1; end > 0; end--) {                                                  \
+            int value = arr[end];                                                                   \
+            arr[end] = arr[0];                                                                      \
+            stats->swaps++;                                                                         \
+            heapSiftDown##SUFFIX(arr, end, 0, 0, value, SORTLIB_HEAP_ARITY, ascending, stats, NULL); \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+// Block merge sort: a stable bottom-up merge sort that works within a scratch
+// budget instead of sortlib_mergeSortArray's size/2 buffer. Merges whose shorter run
+// fits the buffer go through it; larger ones are split SymMerge-style (cut the
+// longer run in half, binary search the cut in the other, rotate the middle
+// parts together) until the pieces fit. With a zero budget every merge is done
+// by rotations alone: O(1) extra memory, O(n log^2 n) moves.
+size_t sortlib_blockMergeBufferLength(size_t size) {
+    return (size_t)sqrt((double)size) + 1;
+}
+
+// Reports bulk moves to the operation observer one write at a time
+static void traceWrites(const int* arr, size_t begin, size_t end, const sortlib_Observer* observer) {
+    if (!observer) return;
+    for (size_t k = begin; k < end; k++) {
+        TRACE_WRITE(k, arr[k]);
+    }
+}
+
+static void reverseArray(int* arr, size_t begin, size_t end) {
+    while (begin + 1 < end) {
+        int temp = arr[begin];
+        arr[begin++] = arr[--end];
+        arr[end] = temp;
+    }
+}
+
+// Swaps the adjacent blocks arr[first, middle) and arr[middle, last); through
+// the buffer when the shorter one fits, by three reversals otherwise
+static void rotateArray(int* arr, size_t first, size_t middle, size_t last, int* buffer, size_t bufferLength,
+                 sortlib_Stats* stats, const sortlib_Observer* observer) {
+    size_t n1 = middle - first, n2 = last - middle;
+    if (n1 == 0 || n2 == 0) return;
+
+    if (n1 <= n2 && n1 <= bufferLength) {
+        memcpy(buffer, arr + first, n1 * sizeof(int));
+        memmove(arr + first, arr + middle, n2 * sizeof(int));
+        memcpy(arr + first + n2, buffer, n1 * sizeof(int));
+    } else if (n2 <= bufferLength) {
+        memcpy(buffer, arr + middle, n2 * sizeof(int));
+        memmove(arr + first + n2, arr + first, n1 * sizeof(int));
+        memcpy(arr + first, buffer, n2 * sizeof(int));
+    } else {
+        reverseArray(arr, first, middle);
+        reverseArray(arr, middle, last);
+        reverseArray(arr, first, last);
+    }
+    stats->swaps += n1 + n2;
+    traceWrites(arr, first, last, observer);
+}
+
+// lowerBound##SUFFIX: first index in [low, high) whose element does not
+// precede value; upperBound##SUFFIX: first one that value precedes. Cutting
+// the right run with the former and the left run with the latter keeps equal
+// elements of the left run first, so the merge stays stable.
+#define GENERATE_BLOCK_MERGE_SORT_ARRAY(SUFFIX, PRECEDES)                                           \
+static size_t lowerBound##SUFFIX(const int* arr, size_t low, size_t high, int value, sortlib_Stats* stats) { \
+    while (low < high) {                                                                            \
+        size_t mid = low + (high - low) / 2;                                                        \
+        stats->comparisons++;                                                                       \
+        if (PRECEDES(arr[mid], value)) {                                                            \
+            low = mid + 1;                                                                          \
+        } else {                                                                                    \
+            high = mid;                                                                             \
+        }                                                                                           \
+    }                                                                                               \
+    return low;                                                                                     \
+}                                                                                                   \
+                                                                                                    \
+static size_t upperBound##SUFFIX(const int* arr, size_t low, size_t high, int value, sortlib_Stats* stats) { \
+    while (low < high) {                                                                            \
+        size_t mid = low + (high - low) / 2;                                                        \
+        stats->comparisons++;                                                                       \
+        if (PRECEDES(value, arr[mid])) {                                                            \
+            high = mid;                                                                             \
+        } else {                                                                                    \
+            low = mid + 1;                                                                          \
+        }                                                                                           \
+    }                                                                                               \
+    return low;                                                                                     \
+}                                                                                                   \
+                                                                                                    \
+/* The shorter run is copied out; a short right run is merged from the back */                      \
+static void bufferedMerge##SUFFIX(int* arr, size_t left, size_t mid, size_t right, int* buffer, sortlib_Stats* stats, \
+                           const sortlib_Observer* observer) {                                      \
+    size_t n1 = mid - left, n2 = right - mid;                                                       \
+    if (n1 <= n2) {                                                                                 \
+        memcpy(buffer, arr + left, n1 * sizeof(int));                                               \
+        size_t i = 0, j = mid, k = left;                                                            \
+        while (i < n1 && j < right) {                                                               \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(k, j);                                                                    \
+            if (!PRECEDES(arr[j], buffer[i])) {                                                     \
+                arr[k] = buffer[i++];                                                               \
+            } else {                                                                                \
+                arr[k] = arr[j++];                                                                  \
+                stats->swaps++;                                                                     \
+            }                                                                                       \
+            TRACE_WRITE(k, arr[k]);                                                                 \
+            k++;                                                                                    \
+        }                                                                                           \
+        while (i < n1) {                                                                            \
+            arr[k] = buffer[i++];                                                                   \
+            TRACE_WRITE(k, arr[k]);                                                                 \
+            k++;                                                                                    \
+        }                                                                                           \
+    } else {                                                                                        \
+        memcpy(buffer, arr + mid, n2 * sizeof(int));                                                \
+        size_t i = mid, j = n2, k = right;                                                          \
+        while (i > left && j > 0) {                                                                 \
+            stats->comparisons++;                                                                   \
+            TRACE_COMPARE(i - 1, k - 1);                                                            \
+            if (PRECEDES(buffer[j - 1], arr[i - 1])) {                                              \
+                arr[--k] = arr[--i];                                                                \
+                stats->swaps++;                                                                     \
+            } else {                                                                                \
+                arr[--k] = buffer[--j];                                                             \
+            }                                                                                       \
+            TRACE_WRITE(k, arr[k]);                                                                 \
+        }                                                                                           \
+        while (j > 0) {                                                                             \
+            arr[--k] = buffer[--j];                                                                 \
+            TRACE_WRITE(k, arr[k]);                                                                 \
+        }                                                                                           \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+/* Splits until the shorter run fits the buffer; recursion only into the                            \
+   smaller half, so the depth stays logarithmic */                                                  \
+static void blockMerge##SUFFIX(int* arr, size_t left, size_t mid, size_t right, int* buffer, size_t bufferLength, \
+                        sortlib_Stats* stats, const sortlib_Observer* observer) {                   \
+    while (left < mid && mid < right) {                                                             \
+        stats->comparisons++;                                                                       \
+        TRACE_COMPARE(mid - 1, mid);                                                                \
+        if (!PRECEDES(arr[mid], arr[mid - 1])) return;  /* Runs already in order */                 \
+                                                                                                    \
+        size_t n1 = mid - left, n2 = right - mid;                                                   \
+        if (n1 <= bufferLength || n2 <= bufferLength) {                                             \
+            bufferedMerge##SUFFIX(arr, left, mid, right, buffer, stats, observer);                 \
+            return;                                                                                 \
+        }                                                                                           \
+                                                                                                    \
+        size_t cut1, cut2;                                                                          \
+        if (n1 >= n2) {                                                                             \
+            cut1 = left + n1 / 2;                                                                   \
+            cut2 = lowerBound##SUFFIX(arr, mid, right, arr[cut1], stats);                           \
+        } else {                                                                                    \
+            cut2 = mid + n2 / 2;                                                                    \
+            cut1 = upperBound##SUFFIX(arr, left, mid, arr[cut2], stats);                            \
+        }                                                                                           \
+        rotateArray(arr, cut1, mid, cut2, buffer, bufferLength, stats, observer);                  \
+        size_t newMid = cut1 + (cut2 - mid);                                                        \
+                                                                                                    \
+        if (newMid - left <= right - newMid) {                                                      \
+            blockMerge##SUFFIX(arr, left, cut1, newMid, buffer, bufferLength, stats, observer);    \
+            left = newMid;                                                                          \
+            mid = cut2;                                                                             \
+        } else {                                                                                    \
+            blockMerge##SUFFIX(arr, newMid, cut2, right, buffer, bufferLength, stats, observer);   \
+            right = newMid;                                                                         \
+            mid = cut1;                                                                             \
+        }                                                                                           \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+/* Insertion-sorted runs of INSERTION_SORT_THRESHOLD, then bottom-up passes;                        \
+   buffer holds bufferLength ints and may be NULL when that is 0 */                                 \
+static void blockMergePasses##SUFFIX(int* arr, size_t size, int* buffer, size_t bufferLength, sortlib_Stats* stats, \
+                              const sortlib_Observer* observer) {                                   \
+    for (size_t left = 0; left < size; left += INSERTION_SORT_THRESHOLD) {                          \
+        size_t right = (size - left > INSERTION_SORT_THRESHOLD) ? left + INSERTION_SORT_THRESHOLD : size; \
+        for (size_t i = left + 1; i < right; i++) {                                                 \
+            int key = arr[i];                                                                       \
+            size_t j = i;                                                                           \
+            while (j > left && PRECEDES(key, arr[j - 1])) {                                         \
+                arr[j] = arr[j - 1];                                                                \
+                j--;                                                                                \
+                stats->comparisons++;                                                               \
+                stats->swaps++;                                                                     \
+            }                                                                                       \
+            stats->comparisons++;                                                                   \
+            arr[j] = key;                                                                           \
+        }                                                                                           \
+        traceWrites(arr, left, right, observer);                                                   \
+        if (SHOW_STEP) {                                                                            \
+            REPORT_STEP(.kind = SORTLIB_STEP_MERGE, .first = left, .second = right - 1, .data = arr, .length = right); \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    for (size_t width = INSERTION_SORT_THRESHOLD; width < size; width *= 2) {                       \
+        for (size_t left = 0; left < size - width; left += 2 * width) {                             \
+            size_t mid = left + width;                                                              \
+            size_t right = (size - mid > width) ? mid + width : size;                               \
+            blockMerge##SUFFIX(arr, left, mid, right, buffer, bufferLength, stats, observer);      \
+            if (SHOW_STEP) {                                                                        \
+                REPORT_STEP(.kind = SORTLIB_STEP_MERGE, .first = left, .second = right - 1, .data = arr, .length = right); \
+            }                                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static void blockMergeSortArrayWithBuffer##SUFFIX(int* arr, size_t size, size_t bufferLength, bool ascending, \
+                                           sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "BLOCK MERGE SORT", .ascending = ascending, \
+                    .data = arr, .length = size);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    /* No merge ever buffers more than half the array */                                            \
+    if (bufferLength > size / 2) bufferLength = size / 2;                                           \
+    int* buffer = NULL;                                                                             \
+    if (bufferLength > 0) {                                                                         \
+        buffer = trackedMalloc(bufferLength * sizeof(int));                                         \
+        if (!buffer) bufferLength = 0;  /* Rotations only */                                        \
+    }                                                                                               \
+    blockMergePasses##SUFFIX(arr, size, buffer, bufferLength, stats, observer);                    \
+    trackedFree(buffer);                                                                            \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+INSTANTIATE_ORDERS(GENERATE_PIVOT_SELECTION)
+INSTANTIATE_ORDERS(GENERATE_BUBBLE_SORT_ARRAY)
+INSTANTIATE_ORDERS(GENERATE_SELECTION_SORT_ARRAY)
+INSTANTIATE_ORDERS(GENERATE_INSERTION_SORT_ARRAY)
+INSTANTIATE_ORDERS(GENERATE_HEAP_SORT_ARRAY)
+INSTANTIATE_ORDERS(GENERATE_MERGE_SORT_ARRAY)
+INSTANTIATE_ORDERS(GENERATE_QUICK_SORT_ARRAY)
+INSTANTIATE_ORDERS(GENERATE_COMB_SORT_ARRAY)
+GENERATE_PARTIAL_SORT_ARRAY(Ascending, ASCENDING_PRECEDES)
+GENERATE_PARTIAL_SORT_ARRAY(Descending, DESCENDING_PRECEDES)
+GENERATE_BLOCK_MERGE_SORT_ARRAY(Ascending, ASCENDING_PRECEDES)
+GENERATE_BLOCK_MERGE_SORT_ARRAY(Descending, DESCENDING_PRECEDES)
+
+// Stability probes (sortlib_private.h): records packed into an int, compared
+// by their upper 16 bits only, so the lower 16 bits show how ties were ordered
+#define RECORD_PRECEDES(a, b) (SORTLIB_RECORD_KEY(a) < SORTLIB_RECORD_KEY(b))
+GENERATE_HEAP_SORT_KERNELS(Records, RECORD_PRECEDES)
+GENERATE_MERGE_SORT_ARRAY(Records, RECORD_PRECEDES)
+GENERATE_BLOCK_MERGE_SORT_ARRAY(Records, RECORD_PRECEDES)
+
+DEFINE_ORDER_DISPATCH(bubbleSortArray, ARRAY_SORT_PARAMS, ARRAY_SORT_ARGS)
+DEFINE_ORDER_DISPATCH(selectionSortArray, ARRAY_SORT_PARAMS, ARRAY_SORT_ARGS)
+DEFINE_ORDER_DISPATCH(insertionSortArray, ARRAY_SORT_PARAMS, ARRAY_SORT_ARGS)
+DEFINE_ORDER_DISPATCH(mergeSortArray, ARRAY_SORT_PARAMS, ARRAY_SORT_ARGS)
+DEFINE_ORDER_DISPATCH(quickSortArray, ARRAY_SORT_PARAMS, ARRAY_SORT_ARGS)
+DEFINE_ORDER_DISPATCH(combSortArray, ARRAY_SORT_PARAMS, ARRAY_SORT_ARGS)
+DEFINE_ORDER_DISPATCH(heapSortArray, ARRAY_SORT_PARAMS, ARRAY_SORT_ARGS)
+DEFINE_ORDER_DISPATCH(heapSortArrayWithArity,
+                      (int* arr, size_t size, unsigned int arity, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer),
+                      (arr, size, arity, ascending, stats, observer))
+DEFINE_HELPER_ORDER_DISPATCH(partialSortArray,
+                      (int* arr, size_t size, size_t k, bool ascending, sortlib_Stats* stats),
+                      (arr, size, k, ascending, stats))
+DEFINE_ORDER_DISPATCH(blockMergeSortArrayWithBuffer,
+                      (int* arr, size_t size, size_t bufferLength, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer),
+                      (arr, size, bufferLength, ascending, stats, observer))
+
+void sortlib_blockMergeSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                 const sortlib_Observer* observer) {
+    sortlib_blockMergeSortArrayWithBuffer(arr, size, sortlib_blockMergeBufferLength(size), ascending, stats, observer);
+}
+
+void sortlib_mergeSortRecords(int* records, size_t size, sortlib_Stats* stats) {
+    mergeSortArrayRecords(records, size, true, stats, NULL);
+}
+
+void sortlib_blockMergeSortRecords(int* records, size_t size, size_t bufferLength, sortlib_Stats* stats) {
+    blockMergeSortArrayWithBufferRecords(records, size, bufferLength, true, stats, NULL);
+}
+
+// Scratch estimates of the table engines
+static size_t noScratchBytes(size_t size) {
+    (void)size;
+    return 0;
+}
+
+static size_t mergeScratchBytes(size_t size) {
+    return mergeBufferLength(size) * sizeof(int);
+}
+
+// sortlib_countingSortWins caps the range below SORTLIB_COUNTING_RANGE_FACTOR * (size + 1) keys
+static size_t countingScratchBytes(size_t size) {
+    size_t range = SORTLIB_COUNTING_MAX_RANGE;
+    if (size < SORTLIB_COUNTING_MAX_RANGE / SORTLIB_COUNTING_RANGE_FACTOR) range = SORTLIB_COUNTING_RANGE_FACTOR * (size + 1) - 1;
+    return range * sizeof(size_t);
+}
+
+// Counters, or the radix sort buffer for wide ranges
+static size_t autoScratchBytes(size_t size) {
+    size_t radixBytes = size * sizeof(int);
+    size_t countingBytes = countingScratchBytes(size);
+    return countingBytes > radixBytes ? countingBytes : radixBytes;
+}
+
+static size_t blockMergeScratchBytes(size_t size) {
+    size_t length = sortlib_blockMergeBufferLength(size);
+    return (length < size / 2 ? length : size / 2) * sizeof(int);
+}
+
+const ArrayAlgorithm sortlib_arrayAlgorithms[NUM_ARRAY_ALGORITHMS] = {
+    {"Bubble Sort", sortlib_bubbleSortArray, noScratchBytes},
+    {"Selection Sort", sortlib_selectionSortArray, noScratchBytes},
+    {"Insertion Sort", sortlib_insertionSortArray, noScratchBytes},
+    {"Merge Sort", sortlib_mergeSortArray, mergeScratchBytes},
+    {"Quick Sort", sortlib_quickSortArray, noScratchBytes},
+    {"Comb Sort", sortlib_combSortArray, noScratchBytes},
+    {"Heap Sort", sortlib_heapSortArray, noScratchBytes},
+    {"Counting Sort", sortlib_countingSortArray, countingScratchBytes},
+    {"Auto", sortlib_autoSortArray, autoScratchBytes},
+    {"Block Merge", sortlib_blockMergeSortArray, blockMergeScratchBytes},
+};
+
+// Same engines with the per-comparison order check, for the specialization benchmark
+const ArrayAlgorithm sortlib_runtimeOrderAlgorithms[NUM_RUNTIME_ORDER_ALGORITHMS] = {
+    {"Bubble Sort", bubbleSortArrayRuntimeOrder, noScratchBytes},
+    {"Selection Sort", selectionSortArrayRuntimeOrder, noScratchBytes},
+    {"Insertion Sort", insertionSortArrayRuntimeOrder, noScratchBytes},
+    {"Merge Sort", mergeSortArrayRuntimeOrder, mergeScratchBytes},
+    {"Quick Sort", quickSortArrayRuntimeOrder, noScratchBytes},
+    {"Comb Sort", combSortArrayRuntimeOrder, noScratchBytes},
+    {"Heap Sort", heapSortArrayRuntimeOrder, noScratchBytes},
+};
+
+// ============================================================================
+// SORTING ALGORITHMS - TYPED ARRAYS
+// ============================================================================
+
+// The same engines for int32/int64/uint32/uint64/float/double keys, named
+// <engine>Sort<Type> (e.g. sortlib_quickSortInt64, sortlib_radixSortDouble). They never print
+// steps. Floating-point NaNs compare greater than every number in ascending
+// order and smaller in descending order, so NaNs always end up last and every
+// engine, radix included, produces the same order.
+#define INTEGER_ASCENDING(a, b) ((a) < (b))
+#define INTEGER_DESCENDING(a, b) ((a) > (b))
+#define FLOAT_ASCENDING(a, b) ((a) < (b) || (isnan(b) && !isnan(a)))
+#define FLOAT_DESCENDING(a, b) ((a) > (b) || (isnan(b) && !isnan(a)))
+#define NEVER_NAN(value) false
+
+// Order-preserving maps to unsigned keys: flip the sign bit of two's
+// complement values; for IEEE-754 flip every bit of negatives (their
+// magnitude order is reversed) and only the sign bit of positives
+static uint32_t radixKeyInt32(int32_t value) {
+    return (uint32_t)value ^ 0x80000000u;
+}
+
+static uint32_t radixKeyUInt32(uint32_t value) {
+    return value;
+}
+
+static uint64_t radixKeyInt64(int64_t value) {
+    return (uint64_t)value ^ 0x8000000000000000ULL;
+}
+
+static uint64_t radixKeyUInt64(uint64_t value) {
+    return value;
+}
+
+static uint32_t radixKeyFloat(float value) {
+    if (value == 0.0f) value = 0.0f;  // -0.0 and 0.0 compare equal, so share a key
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+}
+
+static uint64_t radixKeyDouble(double value) {
+    if (value == 0.0) value = 0.0;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x8000000000000000ULL) ? ~bits : bits ^ 0x8000000000000000ULL;
+}
+
+#define GENERATE_TYPED_SORT_KERNELS(TYPE, NAME, SUFFIX, PRECEDES)                                   \
+/* Insertion sort without timing, used for whole arrays and small ranges */                         \
+static void insertionRun##NAME##SUFFIX(TYPE* arr, size_t size, sortlib_Stats* stats) {              \
+    for (size_t i = 1; i < size; i++) {                                                             \
+        TYPE key = arr[i];                                                                          \
+        size_t j = i;                                                                               \
+        while (j > 0 && PRECEDES(key, arr[j - 1])) {                                                \
+            arr[j] = arr[j - 1];                                                                    \
+            j--;                                                                                    \
+            stats->comparisons++;                                                                   \
+            stats->swaps++;                                                                         \
+        }                                                                                           \
+        stats->comparisons++;                                                                       \
+        arr[j] = key;                                                                               \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static void insertionSort##NAME##SUFFIX(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats) { \
+    (void)ascending;                                                                                \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+    insertionRun##NAME##SUFFIX(arr, size, stats);                                                   \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}                                                                                                   \
+                                                                                                    \
+/* SORTLIB_HEAP_ARITY-ary heap with the same bottom-up sift-down as sortlib_heapSortArray */        \
+static void heapSiftDown##NAME##SUFFIX(TYPE* arr, size_t size, size_t hole, size_t top, TYPE value, sortlib_Stats* stats) { \
+    size_t child;                                                                                   \
+    while ((child = SORTLIB_HEAP_ARITY * hole + 1) < size) {                                        \
+        size_t end = (size - child > SORTLIB_HEAP_ARITY) ? child + SORTLIB_HEAP_ARITY : size;       \
+        size_t best = child;                                                                        \
+        for (size_t c = child + 1; c < end; c++) {                                                  \
+            stats->comparisons++;                                                                   \
+            if (PRECEDES(arr[best], arr[c])) best = c;                                              \
+        }                                                                                           \
+        arr[hole] = arr[best];                                                                      \
+        hole = best;                                                                                \
+        stats->swaps++;                                                                             \
+    }                                                                                               \
+                                                                                                    \
+    while (hole > top) {                                                                            \
+        size_t parent = (hole - 1) / SORTLIB_HEAP_ARITY;                                            \
+        stats->comparisons++;                                                                       \
+        if (!PRECEDES(arr[parent], value)) break;                                                   \
+        arr[hole] = arr[parent];                                                                    \
+        hole = parent;                                                                              \
+        stats->swaps++;                                                                             \
+    }                                                                                               \
+    arr[hole] = value;                                                                              \
+}                                                                                                   \
+                                                                                                    \
+/* Heap sort without timing; quick sort finishes ranges out of depth with it */                     \
+static void heapSortRun##NAME##SUFFIX(TYPE* arr, size_t size, sortlib_Stats* stats) {               \
+    if (size > 1) {                                                                                 \
+        for (size_t i = (size - 2) / SORTLIB_HEAP_ARITY + 1; i-- > 0; ) {                           \
+            heapSiftDown##NAME##SUFFIX(arr, size, i, i, arr[i], stats);                             \
+        }                                                                                           \
+        for (size_t end = size - 1; end > 0; end--) {                                               \
+            TYPE value = arr[end];                                                                  \
+            arr[end] = arr[0];                                                                      \
+            stats->swaps++;                                                                         \
+            heapSiftDown##NAME##SUFFIX(arr, end, 0, 0, value, stats);                               \
+        }                                                                                           \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static void heapSort##NAME##SUFFIX(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats) {  \
+    (void)ascending;                                                                                \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+    heapSortRun##NAME##SUFFIX(arr, size, stats);                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}                                                                                                   \
+                                                                                                    \
+/* Bottom-up merge sort over insertion-sorted blocks of INSERTION_SORT_THRESHOLD;                   \
+   without scratch for it the array is heap sorted instead (not stable) */                          \
+static void mergeSort##NAME##SUFFIX(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats) { \
+    (void)ascending;                                                                                \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    TYPE* buffer = NULL;                                                                            \
+    if (size > INSERTION_SORT_THRESHOLD) {                                                          \
+        buffer = trackedMalloc(size * sizeof(TYPE));                                                \
+        if (!buffer) {                                                                              \
+            heapSort##NAME##SUFFIX(arr, size, ascending, stats);                                    \
+            return;                                                                                 \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    for (size_t left = 0; left < size; left += INSERTION_SORT_THRESHOLD) {                          \
+        size_t length = (size - left > INSERTION_SORT_THRESHOLD) ? INSERTION_SORT_THRESHOLD : size - left; \
+        insertionRun##NAME##SUFFIX(arr + left, length, stats);                                      \
+    }                                                                                               \
+                                                                                                    \
+    if (buffer) {                                                                                   \
+        for (size_t width = INSERTION_SORT_THRESHOLD; width < size; width *= 2) {                   \
+            for (size_t left = 0; left < size - width; left += 2 * width) {                         \
+                size_t mid = left + width;                                                          \
+                size_t right = (size - mid > width) ? mid + width : size;                           \
+                                                                                                    \
+                stats->comparisons++;                                                               \
+                if (!PRECEDES(arr[mid], arr[mid - 1])) continue;  /* Runs already in order */       \
+                                                                                                    \
+                size_t n1 = mid - left;                                                             \
+                memcpy(buffer, arr + left, n1 * sizeof(TYPE));                                      \
+                size_t i = 0, j = mid, k = left;                                                    \
+                while (i < n1 && j < right) {                                                       \
+                    stats->comparisons++;                                                           \
+                    if (!PRECEDES(arr[j], buffer[i])) {                                             \
+                        arr[k++] = buffer[i++];                                                     \
+                    } else {                                                                        \
+                        arr[k++] = arr[j++];                                                        \
+                        stats->swaps++;                                                             \
+                    }                                                                               \
+                }                                                                                   \
+                while (i < n1) arr[k++] = buffer[i++];                                              \
+            }                                                                                       \
+        }                                                                                           \
+        trackedFree(buffer);                                                                        \
+    }                                                                                               \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}                                                                                                   \
+                                                                                                    \
+static TYPE medianOfThree##NAME##SUFFIX(TYPE a, TYPE b, TYPE c, sortlib_Stats* stats) {             \
+    stats->comparisons += 3;                                                                        \
+    return PRECEDES(a, b) ? (PRECEDES(b, c) ? b : PRECEDES(a, c) ? c : a)                           \
+                          : (PRECEDES(a, c) ? a : PRECEDES(b, c) ? c : b);                          \
+}                                                                                                   \
+                                                                                                    \
+/* Three-way quicksort with the pivots of pivotIndex (median of three, ninther                      \
+   of xorshift-drawn positions above NINTHER_THRESHOLD); recursion only into                        \
+   the smaller side, duplicates (and NaNs) collapse into the middle band, and                       \
+   ranges still partitioning after depth levels are heap sorted */                                  \
+static void quickSortRange##NAME##SUFFIX(TYPE* arr, size_t size, size_t depth, sortlib_Stats* stats) { \
+    while (size > INSERTION_SORT_THRESHOLD) {                                                       \
+        if (depth == 0) {                                                                           \
+            heapSortRun##NAME##SUFFIX(arr, size, stats);                                            \
+            return;                                                                                 \
+        }                                                                                           \
+        depth--;                                                                                    \
+                                                                                                    \
+        TYPE pivot;                                                                                 \
+        if (size <= NINTHER_THRESHOLD) {                                                            \
+            pivot = medianOfThree##NAME##SUFFIX(arr[0], arr[size / 2], arr[size - 1], stats);       \
+        } else {                                                                                    \
+            uint64_t state = 0x9E3779B97F4A7C15ULL ^ size;                                          \
+            TYPE medians[3];                                                                        \
+            for (int m = 0; m < 3; m++) {                                                           \
+                TYPE a = arr[xorshift64(&state) % size];                                            \
+                TYPE b = arr[xorshift64(&state) % size];                                            \
+                TYPE c = arr[xorshift64(&state) % size];                                            \
+                medians[m] = medianOfThree##NAME##SUFFIX(a, b, c, stats);                           \
+            }                                                                                       \
+            pivot = medianOfThree##NAME##SUFFIX(medians[0], medians[1], medians[2], stats);         \
+        }                                                                                           \
+                                                                                                    \
+        size_t lt = 0, i = 0, gt = size;                                                            \
+        while (i < gt) {                                                                            \
+            stats->comparisons++;                                                                   \
+            if (PRECEDES(arr[i], pivot)) {                                                          \
+                TYPE temp = arr[lt]; arr[lt++] = arr[i]; arr[i++] = temp;                           \
+                stats->swaps++;                                                                     \
+            } else if (PRECEDES(pivot, arr[i])) {                                                   \
+                TYPE temp = arr[--gt]; arr[gt] = arr[i]; arr[i] = temp;                             \
+                stats->swaps++;                                                                     \
+            } else {                                                                                \
+                i++;                                                                                \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        if (lt < size - gt) {                                                                       \
+            quickSortRange##NAME##SUFFIX(arr, lt, depth, stats);                                    \
+            arr += gt;                                                                              \
+            size -= gt;                                                                             \
+        } else {                                                                                    \
+            quickSortRange##NAME##SUFFIX(arr + gt, size - gt, depth, stats);                        \
+            size = lt;                                                                              \
+        }                                                                                           \
+    }                                                                                               \
+    insertionRun##NAME##SUFFIX(arr, size, stats);                                                   \
+}                                                                                                   \
+                                                                                                    \
+static void quickSort##NAME##SUFFIX(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats) { \
+    (void)ascending;                                                                                \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+    quickSortRange##NAME##SUFFIX(arr, size, quickSortDepthLimit(size), stats);                      \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+// Stable LSD radix sort on the order-preserving keys. One read pass builds the
+// histograms of every digit; passes where every key shares the digit are skipped.
+#define GENERATE_TYPED_RADIX_SORT(TYPE, NAME, KEY_TYPE, IS_NAN)                                     \
+static KEY_TYPE orderedKey##NAME(TYPE value, bool ascending) {                                      \
+    if (IS_NAN(value)) return (KEY_TYPE)~(KEY_TYPE)0;  /* NaN last in both orders */                \
+    KEY_TYPE key = radixKey##NAME(value);                                                           \
+    return ascending ? key : (KEY_TYPE)~key;                                                        \
+}                                                                                                   \
+                                                                                                    \
+void sortlib_radixSort##NAME(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats) {        \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    enum { PASSES = sizeof(KEY_TYPE) * CHAR_BIT / RADIX_BITS };                                     \
+    size_t counts[PASSES][RADIX_BUCKETS];                                                           \
+    memset(counts, 0, sizeof(counts));                                                              \
+    for (size_t i = 0; i < size; i++) {                                                             \
+        KEY_TYPE key = orderedKey##NAME(arr[i], ascending);                                         \
+        for (unsigned int p = 0; p < PASSES; p++) {                                                 \
+            counts[p][(key >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;                           \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    TYPE* buffer = trackedMalloc((size ? size : 1) * sizeof(TYPE));                                 \
+    if (!buffer) {                                                                                  \
+        sortlib_heapSort##NAME(arr, size, ascending, stats);  /* No scratch: in place */            \
+        return;                                                                                     \
+    }                                                                                               \
+    TYPE* src = arr;                                                                                \
+    TYPE* dst = buffer;                                                                             \
+                                                                                                    \
+    for (unsigned int p = 0; p < PASSES; p++) {                                                     \
+        size_t running = 0;                                                                         \
+        bool trivialPass = false;                                                                   \
+        for (unsigned int d = 0; d < RADIX_BUCKETS; d++) {                                          \
+            size_t count = counts[p][d];                                                            \
+            counts[p][d] = running;                                                                 \
+            running += count;                                                                       \
+            if (count == size) trivialPass = true;                                                  \
+        }                                                                                           \
+        if (trivialPass) continue;  /* Every key shares this digit */                               \
+                                                                                                    \
+        unsigned int shift = p * RADIX_BITS;                                                        \
+        for (size_t i = 0; i < size; i++) {                                                         \
+            KEY_TYPE key = orderedKey##NAME(src[i], ascending);                                     \
+            dst[counts[p][(key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];                        \
+        }                                                                                           \
+        stats->swaps += size;                                                                       \
+                                                                                                    \
+        TYPE* temp = src;                                                                           \
+        src = dst;                                                                                  \
+        dst = temp;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    if (src != arr) {                                                                               \
+        memcpy(arr, src, size * sizeof(TYPE));                                                      \
+    }                                                                                               \
+    trackedFree(buffer);                                                                            \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+#define TYPED_SORT_PARAMS(TYPE) (TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats)
+#define TYPED_SORT_ARGS (arr, size, ascending, stats)
+
+#define GENERATE_TYPED_ARRAY_SORTS(TYPE, NAME, KEY_TYPE, ASCENDING, DESCENDING, IS_NAN)             \
+GENERATE_TYPED_SORT_KERNELS(TYPE, NAME, Ascending, ASCENDING)                                       \
+GENERATE_TYPED_SORT_KERNELS(TYPE, NAME, Descending, DESCENDING)                                     \
+DEFINE_ORDER_DISPATCH(insertionSort##NAME, TYPED_SORT_PARAMS(TYPE), TYPED_SORT_ARGS)                \
+DEFINE_ORDER_DISPATCH(mergeSort##NAME, TYPED_SORT_PARAMS(TYPE), TYPED_SORT_ARGS)                    \
+DEFINE_ORDER_DISPATCH(quickSort##NAME, TYPED_SORT_PARAMS(TYPE), TYPED_SORT_ARGS)                    \
+DEFINE_ORDER_DISPATCH(heapSort##NAME, TYPED_SORT_PARAMS(TYPE), TYPED_SORT_ARGS)                     \
+GENERATE_TYPED_RADIX_SORT(TYPE, NAME, KEY_TYPE, IS_NAN)
+
+GENERATE_TYPED_ARRAY_SORTS(int32_t, Int32, uint32_t, INTEGER_ASCENDING, INTEGER_DESCENDING, NEVER_NAN)
+GENERATE_TYPED_ARRAY_SORTS(int64_t, Int64, uint64_t, INTEGER_ASCENDING, INTEGER_DESCENDING, NEVER_NAN)
+GENERATE_TYPED_ARRAY_SORTS(uint32_t, UInt32, uint32_t, INTEGER_ASCENDING, INTEGER_DESCENDING, NEVER_NAN)
+GENERATE_TYPED_ARRAY_SORTS(uint64_t, UInt64, uint64_t, INTEGER_ASCENDING, INTEGER_DESCENDING, NEVER_NAN)
+GENERATE_TYPED_ARRAY_SORTS(float, Float, uint32_t, FLOAT_ASCENDING, FLOAT_DESCENDING, isnan)
+GENERATE_TYPED_ARRAY_SORTS(double, Double, uint64_t, FLOAT_ASCENDING, FLOAT_DESCENDING, isnan)
+
+// ============================================================================
+// SORTING ALGORITHMS - MATRICES
+// ============================================================================
+
+#define GENERATE_BUBBLE_SORT_MATRIX(SUFFIX, PRECEDES)                                               \
+static void bubbleSortMatrix##SUFFIX(char** matrix, unsigned int rows, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "BUBBLE SORT - MATRIX", .ascending = ascending, \
+                    .dataKind = SORTLIB_DATA_STRINGS, .data = matrix, .length = rows);              \
+    }                                                                                               \
+                                                                                                    \
+    bool swapped;                                                                                   \
+    do {                                                                                            \
+        swapped = false;                                                                            \
+        for (unsigned int i = 0; i + 1 < rows; i++) {                                               \
+            stats->comparisons++;                                                                   \
+            if (PRECEDES(matrix[i + 1], matrix[i])) {                                               \
+                swapStrings(matrix[i], matrix[i + 1]);                                              \
+                stats->swaps++;                                                                     \
+                swapped = true;                                                                     \
+                if (SHOW_STEP) {                                                                    \
+                    REPORT_STEP(.kind = SORTLIB_STEP_SWAP, .second = stats->swaps,                  \
+                                .dataKind = SORTLIB_DATA_STRINGS, .data = matrix, .length = rows);  \
+                }                                                                                   \
+            }                                                                                       \
+        }                                                                                           \
+    } while (swapped);                                                                              \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+INSTANTIATE_STRING_ORDERS(GENERATE_BUBBLE_SORT_MATRIX)
+
+DEFINE_ORDER_DISPATCH(bubbleSortMatrix,
+                      (char** matrix, unsigned int rows, bool ascending, sortlib_Stats* stats,
+                       const sortlib_Observer* observer),
+                      (matrix, rows, ascending, stats, observer))
+
+void sortlib_bubbleSortMatrixRuntimeOrder(char** matrix, unsigned int rows, bool ascending, sortlib_Stats* stats,
+                                          const sortlib_Observer* observer) {
+    bubbleSortMatrixRuntimeOrder(matrix, rows, ascending, stats, observer);
+}
+
+// ============================================================================
+// SORTING ALGORITHMS - LINKED LISTS
+// ============================================================================
+
+#define GENERATE_BUBBLE_SORT_LIST(SUFFIX, PRECEDES)                                                 \
+static void bubbleSortList##SUFFIX(sortlib_Node** head, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    if (*head == NULL) return;                                                                      \
+                                                                                                    \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "BUBBLE SORT - LINKED LIST", .ascending = ascending, \
+                    .dataKind = SORTLIB_DATA_LIST, .data = *head);                                  \
+    }                                                                                               \
+                                                                                                    \
+    bool swapped;                                                                                   \
+    sortlib_Node** current;                                                                         \
+                                                                                                    \
+    do {                                                                                            \
+        swapped = false;                                                                            \
+        current = head;                                                                             \
+                                                                                                    \
+        while ((*current)->next != NULL) {                                                          \
+            sortlib_Node* a = *current;                                                             \
+            sortlib_Node* b = a->next;                                                              \
+                                                                                                    \
+            stats->comparisons++;                                                                   \
+            if (PRECEDES(b->info, a->info)) {                                                       \
+                a->next = b->next;                                                                  \
+                b->next = a;                                                                        \
+                *current = b;                                                                       \
+                stats->swaps++;                                                                     \
+                swapped = true;                                                                     \
+                if (SHOW_STEP) {                                                                    \
+                    REPORT_STEP(.kind = SORTLIB_STEP_SWAP, .second = stats->swaps,                  \
+                                .dataKind = SORTLIB_DATA_LIST, .data = *head);                      \
+                }                                                                                   \
+            }                                                                                       \
+            current = &(*current)->next;                                                            \
+        }                                                                                           \
+    } while (swapped);                                                                              \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+#define GENERATE_INSERTION_SORT_LIST(SUFFIX, PRECEDES)                                              \
+static void insertionSortList##SUFFIX(sortlib_Node** head, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) { \
+    if (*head == NULL) return;                                                                      \
+                                                                                                    \
+    stats->comparisons = 0;                                                                         \
+    stats->swaps = 0;                                                                               \
+    double startTime = sortlib_timeMs();                                                            \
+                                                                                                    \
+    if (SHOW_STEP) {                                                                                \
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "INSERTION SORT - LINKED LIST", .ascending = ascending, \
+                    .dataKind = SORTLIB_DATA_LIST, .data = *head);                                  \
+    }                                                                                               \
+                                                                                                    \
+    sortlib_Node* sorted = NULL;                                                                    \
+    sortlib_Node* current = *head;                                                                  \
+                                                                                                    \
+    while (current != NULL) {                                                                       \
+        sortlib_Node* next = current->next;                                                         \
+                                                                                                    \
+        if (sorted == NULL || PRECEDES(current->info, sorted->info)) {                              \
+            current->next = sorted;                                                                 \
+            sorted = current;                                                                       \
+            stats->swaps++;                                                                         \
+            stats->comparisons++;                                                                   \
+        } else {                                                                                    \
+            sortlib_Node* temp = sorted;                                                            \
+            /* Past equal strings too: later inserts go behind them, which keeps it stable */       \
+            while (temp->next != NULL && !PRECEDES(current->info, temp->next->info)) {              \
+                temp = temp->next;                                                                  \
+                stats->comparisons++;                                                               \
+            }                                                                                       \
+            current->next = temp->next;                                                             \
+            temp->next = current;                                                                   \
+            stats->swaps++;                                                                         \
+        }                                                                                           \
+        current = next;                                                                             \
+        if (SHOW_STEP) {                                                                            \
+            REPORT_STEP(.kind = SORTLIB_STEP_INSERT, .first = stats->swaps, .dataKind = SORTLIB_DATA_LIST, .data = sorted); \
+        }                                                                                           \
+    }                                                                                               \
+    *head = sorted;                                                                                 \
+                                                                                                    \
+    stats->execution_time_ms = sortlib_timeMs() - startTime;                                        \
+}
+
+// No RuntimeOrder list kernels: the specialization benchmark measures that on the matrix
+GENERATE_BUBBLE_SORT_LIST(Ascending, STRING_ASCENDING_PRECEDES)
+GENERATE_BUBBLE_SORT_LIST(Descending, STRING_DESCENDING_PRECEDES)
+GENERATE_INSERTION_SORT_LIST(Ascending, STRING_ASCENDING_PRECEDES)
+GENERATE_INSERTION_SORT_LIST(Descending, STRING_DESCENDING_PRECEDES)
+
+DEFINE_ORDER_DISPATCH(bubbleSortList,
+                      (sortlib_Node** head, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer),
+                      (head, ascending, stats, observer))
+DEFINE_ORDER_DISPATCH(insertionSortList,
+                      (sortlib_Node** head, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer),
+                      (head, ascending, stats, observer))
+
+// ============================================================================
+// SORTING ALGORITHMS - PARALLEL
+// ============================================================================
+
+// Sequential kernel used for sample-sort buckets: three-way partitioning
+// collapses duplicates into the middle band, pivots come from pivotIndex and
+// recursion goes only into the smaller side. A range still unsorted after
+// quickSortDepthLimit levels is heap sorted, so no input is worse than
+// O(n log n).
+#define GENERATE_THREE_WAY_QUICK_SORT(SUFFIX, PRECEDES)                                             \
+static void threeWayQuickSortRange##SUFFIX(int* arr, size_t size, size_t depth, bool ascending, sortlib_Stats* stats) { \
+    while (size > INSERTION_SORT_THRESHOLD) {                                                       \
+        if (depth == 0) {                                                                           \
+            heapSortRange##SUFFIX(arr, size, SORTLIB_HEAP_ARITY, ascending, stats, NULL);           \
+            return;                                                                                 \
+        }                                                                                           \
+        depth--;                                                                                    \
+        int pivot = arr[pivotIndex##SUFFIX(arr, 0, size, ascending, stats)];                        \
+                                                                                                    \
+        size_t lt = 0, i = 0, gt = size;                                                            \
+        while (i < gt) {                                                                            \
+            stats->comparisons++;                                                                   \
+            if (PRECEDES(arr[i], pivot)) {                                                          \
+                swap(&arr[lt++], &arr[i++]);                                                        \
+                stats->swaps++;                                                                     \
+            } else if (PRECEDES(pivot, arr[i])) {                                                   \
+                swap(&arr[i], &arr[--gt]);                                                          \
+                stats->swaps++;                                                                     \
+            } else {                                                                                \
+                i++;                                                                                \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        size_t leftSize = lt;                                                                       \
+        size_t rightSize = size - gt;                                                               \
+        if (leftSize < rightSize) {                                                                 \
+            threeWayQuickSortRange##SUFFIX(arr, leftSize, depth, ascending, stats);                 \
+            arr += gt;                                                                              \
+            size = rightSize;                                                                       \
+        } else {                                                                                    \
+            threeWayQuickSortRange##SUFFIX(arr + gt, rightSize, depth, ascending, stats);           \
+            size = leftSize;                                                                        \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    for (size_t i = 1; i < size; i++) {                                                             \
+        int key = arr[i];                                                                           \
+        size_t j = i;                                                                               \
+        while (j > 0 && PRECEDES(key, arr[j - 1])) {                                                \
+            arr[j] = arr[j - 1];                                                                    \
+            j--;                                                                                    \
+            stats->comparisons++;                                                                   \
+            stats->swaps++;                                                                         \
+        }                                                                                           \
+        stats->comparisons++;                                                                       \
+        arr[j] = key;                                                                               \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static void threeWayQuickSort##SUFFIX(int* arr, size_t size, bool ascending, sortlib_Stats* stats) { \
+    threeWayQuickSortRange##SUFFIX(arr, size, quickSortDepthLimit(size), ascending, stats);         \
+}
+
+GENERATE_THREE_WAY_QUICK_SORT(Ascending, ASCENDING_PRECEDES)
+GENERATE_THREE_WAY_QUICK_SORT(Descending, DESCENDING_PRECEDES)
+
+DEFINE_ORDER_DISPATCH(threeWayQuickSort,
+                      (int* arr, size_t size, bool ascending, sortlib_Stats* stats),
+                      (arr, size, ascending, stats))
+
+
+typedef struct {
+    int* src;
+    int* dst;
+    size_t size;
+    unsigned int shift;
+    bool ascending;
+    unsigned int numThreads;
+    size_t counts[SORTLIB_MAX_THREADS][RADIX_BUCKETS];
+} RadixPassContext;
+
+// Maps a signed key to an unsigned digit so that digit order is sort order
+static unsigned int radixDigit(int value, unsigned int shift, bool ascending) {
+    unsigned int digit = ((((uint32_t)value) ^ 0x80000000u) >> shift) & (RADIX_BUCKETS - 1);
+    return ascending ? digit : (RADIX_BUCKETS - 1) - digit;
+}
+
+static void radixHistogramTask(void* arg, unsigned int threadId) {
+    RadixPassContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->size, ctx->numThreads, threadId, &begin, &end);
+    
+    size_t* counts = ctx->counts[threadId];
+    memset(counts, 0, RADIX_BUCKETS * sizeof(size_t));
+    for (size_t i = begin; i < end; i++) {
+        counts[radixDigit(ctx->src[i], ctx->shift, ctx->ascending)]++;
+    }
+}
+
+static void radixScatterTask(void* arg, unsigned int threadId) {
+    RadixPassContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->size, ctx->numThreads, threadId, &begin, &end);
+    
+    size_t* offsets = ctx->counts[threadId];
+    for (size_t i = begin; i < end; i++) {
+        int value = ctx->src[i];
+        ctx->dst[offsets[radixDigit(value, ctx->shift, ctx->ascending)]++] = value;
+    }
+}
+
+// The sort itself on caller-provided memory: buffer holds size ints
+static void parallelRadixPasses(int* arr, int* buffer, size_t size, bool ascending, sortlib_Stats* stats, sortlib_ThreadPool* pool,
+                         RadixPassContext* ctx) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    
+    ctx->src = arr;
+    ctx->dst = buffer;
+    ctx->size = size;
+    ctx->ascending = ascending;
+    ctx->numThreads = pool->numThreads;
+    
+    for (unsigned int shift = 0; shift < 32; shift += RADIX_BITS) {
+        ctx->shift = shift;
+        sortlib_runThreadPool(pool, radixHistogramTask, ctx);
+        
+        // Exclusive prefix sum, digit-major so each thread scatters stably
+        size_t running = 0;
+        bool trivialPass = false;
+        for (unsigned int d = 0; d < RADIX_BUCKETS; d++) {
+            size_t digitTotal = 0;
+            for (unsigned int t = 0; t < ctx->numThreads; t++) {
+                size_t count = ctx->counts[t][d];
+                ctx->counts[t][d] = running;
+                running += count;
+                digitTotal += count;
+            }
+            if (digitTotal == size) trivialPass = true;
+        }
+        if (trivialPass) continue;  // Every key shares this digit
+        
+        sortlib_runThreadPool(pool, radixScatterTask, ctx);
+        stats->swaps += size;
+        
+        int* temp = ctx->src;
+        ctx->src = ctx->dst;
+        ctx->dst = temp;
+    }
+    
+    if (ctx->src != arr) {
+        memcpy(arr, ctx->src, size * sizeof(int));
+    }
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+void sortlib_parallelRadixSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats, sortlib_ThreadPool* pool) {
+    double startTime = sortlib_timeMs();
+    
+    RadixPassContext* ctx = trackedMalloc(sizeof(RadixPassContext));
+    int* buffer = trackedMallocPages(size * sizeof(int), pool->scratchPages);
+    if (!ctx || !buffer) {
+        // No scratch: sort in place on this thread
+        trackedFree(buffer);
+        trackedFree(ctx);
+        sortlib_threeWayQuickSort(arr, size, ascending, stats);
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    parallelRadixPasses(arr, buffer, size, ascending, stats, pool, ctx);
+    
+    trackedFree(buffer);
+    trackedFree(ctx);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+typedef struct {
+    int* arr;
+    int* buffer;
+    size_t size;
+    bool ascending;
+    unsigned int numThreads;
+    unsigned int numBuckets;
+    int splitters[SORTLIB_MAX_THREADS * BUCKETS_PER_THREAD];  // numBuckets - 1, ascending
+    size_t counts[SORTLIB_MAX_THREADS][SORTLIB_MAX_THREADS * BUCKETS_PER_THREAD];
+    size_t bucketStart[SORTLIB_MAX_THREADS * BUCKETS_PER_THREAD + 1];
+    atomic_uint nextBucket;
+    sortlib_Stats threadStats[SORTLIB_MAX_THREADS];
+} SampleSortContext;
+
+static unsigned int sampleSortBucket(const SampleSortContext* ctx, int value, sortlib_Stats* stats) {
+    unsigned int lo = 0, hi = ctx->numBuckets - 1;
+    while (lo < hi) {
+        unsigned int mid = (lo + hi) / 2;
+        stats->comparisons++;
+        if (value < ctx->splitters[mid]) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return ctx->ascending ? lo : ctx->numBuckets - 1 - lo;
+}
+
+static void sampleSortHistogramTask(void* arg, unsigned int threadId) {
+    SampleSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->size, ctx->numThreads, threadId, &begin, &end);
+    
+    size_t* counts = ctx->counts[threadId];
+    memset(counts, 0, ctx->numBuckets * sizeof(size_t));
+    for (size_t i = begin; i < end; i++) {
+        counts[sampleSortBucket(ctx, ctx->arr[i], &ctx->threadStats[threadId])]++;
+    }
+}
+
+static void sampleSortScatterTask(void* arg, unsigned int threadId) {
+    SampleSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->size, ctx->numThreads, threadId, &begin, &end);
+    
+    size_t* offsets = ctx->counts[threadId];
+    for (size_t i = begin; i < end; i++) {
+        int value = ctx->arr[i];
+        ctx->buffer[offsets[sampleSortBucket(ctx, value, &ctx->threadStats[threadId])]++] = value;
+    }
+    ctx->threadStats[threadId].swaps += end - begin;
+}
+
+// Buckets are claimed dynamically so uneven buckets still balance out
+static void sampleSortBucketTask(void* arg, unsigned int threadId) {
+    SampleSortContext* ctx = arg;
+    
+    while (true) {
+        unsigned int b = atomic_fetch_add(&ctx->nextBucket, 1);
+        if (b >= ctx->numBuckets) break;
+        size_t start = ctx->bucketStart[b];
+        size_t count = ctx->bucketStart[b + 1] - start;
+        sortlib_threeWayQuickSort(ctx->buffer + start, count, ctx->ascending, &ctx->threadStats[threadId]);
+        memcpy(ctx->arr + start, ctx->buffer + start, count * sizeof(int));
+    }
+}
+
+void sortlib_parallelSampleSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats, sortlib_ThreadPool* pool) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    
+    unsigned int numBuckets = pool->numThreads * BUCKETS_PER_THREAD;
+    if (pool->numThreads == 1 || size < (size_t)numBuckets * SAMPLE_OVERSAMPLING) {
+        sortlib_threeWayQuickSort(arr, size, ascending, stats);
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    
+    SampleSortContext* ctx = trackedMalloc(sizeof(SampleSortContext));
+    int* buffer = trackedMallocPages(size * sizeof(int), pool->scratchPages);
+    int* samples = trackedMalloc(numBuckets * SAMPLE_OVERSAMPLING * sizeof(int));
+    if (!ctx || !buffer || !samples) {
+        // No scratch: sort in place on this thread
+        trackedFree(samples);
+        trackedFree(buffer);
+        trackedFree(ctx);
+        sortlib_threeWayQuickSort(arr, size, ascending, stats);
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    ctx->arr = arr;
+    ctx->buffer = buffer;
+    ctx->size = size;
+    ctx->ascending = ascending;
+    ctx->numThreads = pool->numThreads;
+    ctx->numBuckets = numBuckets;
+    for (unsigned int t = 0; t < ctx->numThreads; t++) {
+        ctx->threadStats[t].comparisons = 0;
+        ctx->threadStats[t].swaps = 0;
+    }
+    
+    // Oversampled splitters from a deterministic xorshift sequence
+    size_t numSamples = (size_t)numBuckets * SAMPLE_OVERSAMPLING;
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ size;
+    for (size_t i = 0; i < numSamples; i++) {
+        samples[i] = arr[xorshift64(&state) % size];
+    }
+    sortlib_threeWayQuickSort(samples, numSamples, true, stats);
+    for (unsigned int b = 0; b + 1 < numBuckets; b++) {
+        ctx->splitters[b] = samples[(b + 1) * SAMPLE_OVERSAMPLING];
+    }
+    
+    sortlib_runThreadPool(pool, sampleSortHistogramTask, ctx);
+    
+    size_t running = 0;
+    for (unsigned int b = 0; b < numBuckets; b++) {
+        ctx->bucketStart[b] = running;
+        for (unsigned int t = 0; t < ctx->numThreads; t++) {
+            size_t count = ctx->counts[t][b];
+            ctx->counts[t][b] = running;
+            running += count;
+        }
+    }
+    ctx->bucketStart[numBuckets] = running;
+    
+    sortlib_runThreadPool(pool, sampleSortScatterTask, ctx);
+    
+    atomic_store(&ctx->nextBucket, 0);
+    sortlib_runThreadPool(pool, sampleSortBucketTask, ctx);
+    
+    for (unsigned int t = 0; t < ctx->numThreads; t++) {
+        stats->comparisons += ctx->threadStats[t].comparisons;
+        stats->swaps += ctx->threadStats[t].swaps;
+    }
+    
+    trackedFree(samples);
+    trackedFree(buffer);
+    trackedFree(ctx);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+// ============================================================================
+// SORTING ALGORITHMS - COUNTING
+// ============================================================================
+
+// For keys from a small range (generateRandomArray's values lie in [0, 10000)):
+// a min/max pre-pass sizes one counter per possible value, a histogram pass
+// fills them and the output is written value by value, O(size + range) with
+// no comparisons between elements.
+
+// Min/max pre-pass shared by the counting engines; size must be at least 1
+void sortlib_intRange(const int* arr, size_t size, int* minValue, int* maxValue, sortlib_Stats* stats) {
+    int low = arr[0], high = arr[0];
+    for (size_t i = 1; i < size; i++) {
+        if (arr[i] < low) low = arr[i];
+        if (arr[i] > high) high = arr[i];
+    }
+    stats->comparisons += 2 * (size - 1);
+    *minValue = low;
+    *maxValue = high;
+}
+
+size_t sortlib_intRangeLength(int minValue, int maxValue) {
+    return (size_t)((int64_t)maxValue - minValue) + 1;
+}
+
+bool sortlib_countingSortWins(size_t size, size_t range) {
+    return range <= SORTLIB_COUNTING_MAX_RANGE && range / SORTLIB_COUNTING_RANGE_FACTOR <= size;
+}
+
+// Sorts arr, whose values all lie in [minValue, minValue + range), using the
+// caller's range counters
+static void countingSortRange(int* arr, size_t size, int minValue, size_t range, size_t* counts, bool ascending,
+                       sortlib_Stats* stats, const sortlib_Observer* observer) {
+    if (SHOW_STEP) {
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "COUNTING SORT", .ascending = ascending,
+                    .data = arr, .length = size);
+    }
+    
+    memset(counts, 0, range * sizeof(size_t));
+    for (size_t i = 0; i < size; i++) {
+        counts[(size_t)((int64_t)arr[i] - minValue)]++;
+    }
+    if (SHOW_STEP) {
+        REPORT_STEP(.kind = SORTLIB_STEP_RANGE, .value = minValue, .first = range, .data = arr, .length = size);
+    }
+    
+    size_t k = 0;
+    for (size_t r = 0; r < range; r++) {
+        size_t v = ascending ? r : range - 1 - r;
+        if (counts[v] == 0) continue;
+        int value = (int)((int64_t)minValue + (int64_t)v);
+        for (size_t c = counts[v]; c > 0; c--) {
+            arr[k] = value;
+            TRACE_WRITE(k, value);
+            k++;
+        }
+        if (SHOW_STEP) {
+            REPORT_STEP(.kind = SORTLIB_STEP_RUN, .value = value, .first = counts[v], .data = arr, .length = size);
+        }
+    }
+    stats->swaps += size;
+}
+
+// Counting sort when sortlib_countingSortWins, so the counters never outnumber the
+// elements by more than SORTLIB_COUNTING_RANGE_FACTOR. Wider ranges (or no memory for
+// the counters) are quick sorted, or with autoSelect radix sorted from
+// SORTLIB_AUTO_RADIX_MIN_SIZE elements on; radix sort reports no steps, so it is
+// not chosen when they are shown.
+static void rangeSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer, bool autoSelect) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    if (size == 0) {
+        stats->execution_time_ms = 0.0;
+        return;
+    }
+    
+    int minValue, maxValue;
+    sortlib_intRange(arr, size, &minValue, &maxValue, stats);
+    size_t range = sortlib_intRangeLength(minValue, maxValue);
+    
+    size_t* counts = sortlib_countingSortWins(size, range) ? trackedMalloc(range * sizeof(size_t)) : NULL;
+    if (counts) {
+        countingSortRange(arr, size, minValue, range, counts, ascending, stats, observer);
+        trackedFree(counts);
+    } else {
+        unsigned long long rangeComparisons = stats->comparisons;
+        if (autoSelect && !observer && size >= SORTLIB_AUTO_RADIX_MIN_SIZE) {
+            sortlib_radixSortInt32((int32_t*)arr, size, ascending, stats);
+        } else {
+            sortlib_quickSortArray(arr, size, ascending, stats, observer);
+        }
+        stats->comparisons += rangeComparisons;
+    }
+    
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+void sortlib_countingSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) {
+    rangeSortArray(arr, size, ascending, stats, observer, false);
+}
+
+void sortlib_autoSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) {
+    rangeSortArray(arr, size, ascending, stats, observer, true);
+}
+
+// Writes the distinct values of arr in sort order to values and their
+// multiplicities to counts (both with room for size entries) and returns how
+// many there are. arr is not modified. Ranges where counting does not win (or
+// no memory for their counters) sort a copy in values and collapse its runs.
+size_t sortlib_countDistinctInts(const int* arr, size_t size, bool ascending, int* values, size_t* counts,
+                         sortlib_Stats* stats) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    if (size == 0) {
+        stats->execution_time_ms = 0.0;
+        return 0;
+    }
+    
+    int minValue, maxValue;
+    sortlib_intRange(arr, size, &minValue, &maxValue, stats);
+    size_t range = sortlib_intRangeLength(minValue, maxValue);
+    size_t distinct = 0;
+    
+    size_t* histogram = sortlib_countingSortWins(size, range) ? trackedMalloc(range * sizeof(size_t)) : NULL;
+    if (histogram) {
+        memset(histogram, 0, range * sizeof(size_t));
+        for (size_t i = 0; i < size; i++) {
+            histogram[(size_t)((int64_t)arr[i] - minValue)]++;
+        }
+        for (size_t r = 0; r < range; r++) {
+            size_t v = ascending ? r : range - 1 - r;
+            if (histogram[v] == 0) continue;
+            values[distinct] = (int)((int64_t)minValue + (int64_t)v);
+            counts[distinct] = histogram[v];
+            distinct++;
+        }
+        trackedFree(histogram);
+    } else {
+        sortlib_Stats sortStats = {0};
+        memcpy(values, arr, size * sizeof(int));
+        sortlib_threeWayQuickSort(values, size, ascending, &sortStats);
+        stats->comparisons += sortStats.comparisons;
+        stats->swaps += sortStats.swaps;
+        for (size_t i = 0; i < size; i++) {
+            if (distinct > 0 && values[distinct - 1] == values[i]) {
+                counts[distinct - 1]++;
+            } else {
+                values[distinct] = values[i];
+                counts[distinct] = 1;
+                distinct++;
+            }
+        }
+    }
+    
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+    return distinct;
+}
+
+typedef struct {
+    int* arr;
+    size_t size;
+    bool ascending;
+    unsigned int numThreads;
+    int minValue;
+    size_t range;
+    size_t* counts;                  // numThreads rows of range counters; row 0 ends up with the totals
+    size_t* starts;                  // First output index of every rank (value in output order), range + 1
+    int threadMin[SORTLIB_MAX_THREADS];
+    int threadMax[SORTLIB_MAX_THREADS];
+} CountingSortContext;
+
+static void countingRangeTask(void* arg, unsigned int threadId) {
+    CountingSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->size, ctx->numThreads, threadId, &begin, &end);
+    
+    int low = INT_MAX, high = INT_MIN;
+    for (size_t i = begin; i < end; i++) {
+        if (ctx->arr[i] < low) low = ctx->arr[i];
+        if (ctx->arr[i] > high) high = ctx->arr[i];
+    }
+    ctx->threadMin[threadId] = low;
+    ctx->threadMax[threadId] = high;
+}
+
+static void countingHistogramTask(void* arg, unsigned int threadId) {
+    CountingSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->size, ctx->numThreads, threadId, &begin, &end);
+    
+    size_t* counts = ctx->counts + (size_t)threadId * ctx->range;
+    memset(counts, 0, ctx->range * sizeof(size_t));
+    for (size_t i = begin; i < end; i++) {
+        counts[(size_t)((int64_t)ctx->arr[i] - ctx->minValue)]++;
+    }
+}
+
+// Every thread totals the rows for its own slice of values
+static void countingReduceTask(void* arg, unsigned int threadId) {
+    CountingSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->range, ctx->numThreads, threadId, &begin, &end);
+    
+    for (unsigned int t = 1; t < ctx->numThreads; t++) {
+        const size_t* row = ctx->counts + (size_t)t * ctx->range;
+        for (size_t v = begin; v < end; v++) {
+            ctx->counts[v] += row[v];
+        }
+    }
+}
+
+// Every thread writes its own slice of the output, starting from the rank
+// whose run covers the slice's first index
+static void countingFillTask(void* arg, unsigned int threadId) {
+    CountingSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->size, ctx->numThreads, threadId, &begin, &end);
+    if (begin == end) return;
+    
+    size_t lo = 0, hi = ctx->range - 1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (ctx->starts[mid] <= begin) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    
+    size_t k = begin;
+    for (size_t r = lo; k < end; r++) {
+        size_t v = ctx->ascending ? r : ctx->range - 1 - r;
+        int value = (int)((int64_t)ctx->minValue + (int64_t)v);
+        size_t runEnd = ctx->starts[r + 1] < end ? ctx->starts[r + 1] : end;
+        while (k < runEnd) ctx->arr[k++] = value;
+    }
+}
+
+// Multithreaded counting sort: per-thread min/max and histograms, a parallel
+// reduction of the histograms and a parallel fill. Ranges where counting does
+// not win, whose per-thread counters would exceed SORTLIB_COUNTING_MAX_RANGE in
+// total or cannot be allocated use sample sort.
+void sortlib_parallelCountingSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats, sortlib_ThreadPool* pool) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    if (size == 0) {
+        stats->execution_time_ms = 0.0;
+        return;
+    }
+    
+    CountingSortContext* ctx = trackedMalloc(sizeof(CountingSortContext));
+    if (!ctx) {
+        sortlib_parallelSampleSortArray(arr, size, ascending, stats, pool);
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    ctx->arr = arr;
+    ctx->size = size;
+    ctx->ascending = ascending;
+    ctx->numThreads = pool->numThreads;
+    
+    sortlib_runThreadPool(pool, countingRangeTask, ctx);
+    int minValue = INT_MAX, maxValue = INT_MIN;
+    for (unsigned int t = 0; t < ctx->numThreads; t++) {
+        if (ctx->threadMin[t] < minValue) minValue = ctx->threadMin[t];
+        if (ctx->threadMax[t] > maxValue) maxValue = ctx->threadMax[t];
+    }
+    ctx->minValue = minValue;
+    ctx->range = sortlib_intRangeLength(minValue, maxValue);
+    
+    if (!sortlib_countingSortWins(size, ctx->range) || ctx->range > SORTLIB_COUNTING_MAX_RANGE / ctx->numThreads) {
+        trackedFree(ctx);
+        sortlib_parallelSampleSortArray(arr, size, ascending, stats, pool);
+        stats->comparisons += 2 * size;
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    
+    ctx->counts = trackedMallocPages((size_t)ctx->numThreads * ctx->range * sizeof(size_t),
+                                     pool->scratchPages);
+    ctx->starts = trackedMalloc((ctx->range + 1) * sizeof(size_t));
+    if (!ctx->counts || !ctx->starts) {
+        trackedFree(ctx->starts);
+        trackedFree(ctx->counts);
+        trackedFree(ctx);
+        sortlib_parallelSampleSortArray(arr, size, ascending, stats, pool);
+        stats->comparisons += 2 * size;
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    
+    sortlib_runThreadPool(pool, countingHistogramTask, ctx);
+    sortlib_runThreadPool(pool, countingReduceTask, ctx);
+    
+    size_t running = 0;
+    for (size_t r = 0; r < ctx->range; r++) {
+        ctx->starts[r] = running;
+        running += ctx->counts[ascending ? r : ctx->range - 1 - r];
+    }
+    ctx->starts[ctx->range] = running;
+    
+    sortlib_runThreadPool(pool, countingFillTask, ctx);
+    
+    stats->comparisons = 2 * size;
+    stats->swaps = size;
+    trackedFree(ctx->starts);
+    trackedFree(ctx->counts);
+    trackedFree(ctx);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+// ============================================================================
+// SORTING ALGORITHMS - PARALLEL STRINGS
+// ============================================================================
+
+static int compareFromDepth(const char* a, const char* b, size_t depth, sortlib_Stats* stats) {
+    stats->comparisons++;
+    return strcmp(a + depth, b + depth);
+}
+
+// Bentley-Sedgewick multikey quicksort; every string shares its first
+// `depth` bytes, so comparisons start at that offset
+static void multikeyQuickSort(char** strs, size_t count, size_t depth, sortlib_Stats* stats) {
+    while (count > 1) {
+        if (count <= INSERTION_SORT_THRESHOLD) {
+            for (size_t i = 1; i < count; i++) {
+                char* key = strs[i];
+                size_t j = i;
+                while (j > 0 && compareFromDepth(strs[j - 1], key, depth, stats) > 0) {
+                    strs[j] = strs[j - 1];
+                    j--;
+                    stats->swaps++;
+                }
+                strs[j] = key;
+            }
+            return;
+        }
+        
+        unsigned char a = strs[0][depth];
+        unsigned char b = strs[count / 2][depth];
+        unsigned char c = strs[count - 1][depth];
+        unsigned char pivot = (a < b) ? ((b < c) ? b : (a < c) ? c : a)
+                                      : ((a < c) ? a : (b < c) ? c : b);
+        
+        size_t lt = 0, i = 0, gt = count;
+        while (i < gt) {
+            unsigned char ch = strs[i][depth];
+            stats->comparisons++;
+            if (ch < pivot) {
+                char* temp = strs[lt]; strs[lt++] = strs[i]; strs[i++] = temp;
+                stats->swaps++;
+            } else if (ch > pivot) {
+                char* temp = strs[--gt]; strs[gt] = strs[i]; strs[i] = temp;
+                stats->swaps++;
+            } else {
+                i++;
+            }
+        }
+        
+        multikeyQuickSort(strs, lt, depth, stats);
+        multikeyQuickSort(strs + gt, count - gt, depth, stats);
+        
+        // The equal partition continues one byte deeper unless the strings ended
+        if (pivot == '\0') return;
+        strs += lt;
+        count = gt - lt;
+        depth++;
+    }
+}
+
+// Multikey quicksort on the calling thread, reversed for descending order
+static void multikeySortStrings(char** strs, size_t count, bool ascending, sortlib_Stats* stats) {
+    multikeyQuickSort(strs, count, 0, stats);
+    if (!ascending) {
+        for (size_t i = 0; i < count / 2; i++) {
+            char* temp = strs[i];
+            strs[i] = strs[count - 1 - i];
+            strs[count - 1 - i] = temp;
+        }
+    }
+}
+
+typedef struct {
+    char** matrix;
+    char** buffer;
+    size_t rows;
+    size_t depth;                    // Shared prefix length; split byte offset
+    unsigned int numThreads;
+    size_t prefixLength[SORTLIB_MAX_THREADS];
+    size_t counts[SORTLIB_MAX_THREADS][RADIX_BUCKETS];
+    size_t bucketStart[RADIX_BUCKETS + 1];
+    atomic_uint nextBucket;
+    sortlib_Stats threadStats[SORTLIB_MAX_THREADS];
+} StringSortContext;
+
+static void stringPrefixTask(void* arg, unsigned int threadId) {
+    StringSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->rows, ctx->numThreads, threadId, &begin, &end);
+    
+    const char* first = ctx->matrix[0];
+    size_t prefix = strlen(first);
+    for (size_t i = begin; i < end && prefix > 0; i++) {
+        size_t k = 0;
+        while (k < prefix && ctx->matrix[i][k] == first[k]) k++;
+        prefix = k;
+    }
+    ctx->prefixLength[threadId] = prefix;
+}
+
+static void stringHistogramTask(void* arg, unsigned int threadId) {
+    StringSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->rows, ctx->numThreads, threadId, &begin, &end);
+    
+    size_t* counts = ctx->counts[threadId];
+    memset(counts, 0, RADIX_BUCKETS * sizeof(size_t));
+    for (size_t i = begin; i < end; i++) {
+        counts[(unsigned char)ctx->matrix[i][ctx->depth]]++;
+    }
+}
+
+static void stringScatterTask(void* arg, unsigned int threadId) {
+    StringSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->rows, ctx->numThreads, threadId, &begin, &end);
+    
+    size_t* offsets = ctx->counts[threadId];
+    for (size_t i = begin; i < end; i++) {
+        char* str = ctx->matrix[i];
+        ctx->buffer[offsets[(unsigned char)str[ctx->depth]]++] = str;
+    }
+    ctx->threadStats[threadId].swaps += end - begin;
+}
+
+static void stringBucketTask(void* arg, unsigned int threadId) {
+    StringSortContext* ctx = arg;
+    
+    while (true) {
+        unsigned int b = atomic_fetch_add(&ctx->nextBucket, 1);
+        if (b >= RADIX_BUCKETS) break;
+        size_t start = ctx->bucketStart[b];
+        size_t count = ctx->bucketStart[b + 1] - start;
+        // Bucket 0 holds strings that end at the split byte: all equal
+        if (b > 0) {
+            multikeyQuickSort(ctx->buffer + start, count, ctx->depth + 1, &ctx->threadStats[threadId]);
+        }
+        memcpy(ctx->matrix + start, ctx->buffer + start, count * sizeof(char*));
+    }
+}
+
+static void stringReverseTask(void* arg, unsigned int threadId) {
+    StringSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->rows / 2, ctx->numThreads, threadId, &begin, &end);
+    
+    for (size_t i = begin; i < end; i++) {
+        char* temp = ctx->matrix[i];
+        ctx->matrix[i] = ctx->matrix[ctx->rows - 1 - i];
+        ctx->matrix[ctx->rows - 1 - i] = temp;
+    }
+}
+
+// Sorts the row pointers (strings stay where they are): parallel MSD split on
+// the first byte past the common prefix, then multikey quicksort per bucket
+void sortlib_parallelStringSortMatrix(char** matrix, size_t rows, bool ascending, sortlib_Stats* stats, sortlib_ThreadPool* pool, const sortlib_Observer* observer) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    
+    if (SHOW_STEP) {
+        REPORT_STEP(.kind = SORTLIB_STEP_START, .algorithm = "PARALLEL STRING SORT - MATRIX", .ascending = ascending,
+                    .second = pool->numThreads, .dataKind = SORTLIB_DATA_STRINGS, .data = matrix, .length = rows);
+    }
+    if (rows < 2) {
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    
+    StringSortContext* ctx = trackedMalloc(sizeof(StringSortContext));
+    char** buffer = trackedMallocPages(rows * sizeof(char*), pool->scratchPages);
+    if (!ctx || !buffer) {
+        // No scratch: sort in place on this thread
+        trackedFree(buffer);
+        trackedFree(ctx);
+        multikeySortStrings(matrix, rows, ascending, stats);
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return;
+    }
+    ctx->matrix = matrix;
+    ctx->buffer = buffer;
+    ctx->rows = rows;
+    ctx->numThreads = pool->numThreads;
+    for (unsigned int t = 0; t < ctx->numThreads; t++) {
+        ctx->threadStats[t].comparisons = 0;
+        ctx->threadStats[t].swaps = 0;
+    }
+    
+    sortlib_runThreadPool(pool, stringPrefixTask, ctx);
+    ctx->depth = ctx->prefixLength[0];
+    for (unsigned int t = 1; t < ctx->numThreads; t++) {
+        if (ctx->prefixLength[t] < ctx->depth) ctx->depth = ctx->prefixLength[t];
+    }
+    
+    sortlib_runThreadPool(pool, stringHistogramTask, ctx);
+    size_t running = 0;
+    for (unsigned int d = 0; d < RADIX_BUCKETS; d++) {
+        ctx->bucketStart[d] = running;
+        for (unsigned int t = 0; t < ctx->numThreads; t++) {
+            size_t count = ctx->counts[t][d];
+            ctx->counts[t][d] = running;
+            running += count;
+        }
+    }
+    ctx->bucketStart[RADIX_BUCKETS] = running;
+    sortlib_runThreadPool(pool, stringScatterTask, ctx);
+    
+    if (SHOW_STEP) {
+        size_t buckets = 0;
+        for (unsigned int d = 0; d < RADIX_BUCKETS; d++) {
+            if (ctx->bucketStart[d + 1] > ctx->bucketStart[d]) buckets++;
+        }
+        REPORT_STEP(.kind = SORTLIB_STEP_SPLIT, .first = ctx->depth, .second = buckets,
+                    .dataKind = SORTLIB_DATA_STRINGS, .data = buffer, .length = rows);
+    }
+    
+    atomic_store(&ctx->nextBucket, 0);
+    sortlib_runThreadPool(pool, stringBucketTask, ctx);
+    
+    if (!ascending) {
+        sortlib_runThreadPool(pool, stringReverseTask, ctx);
+    }
+    
+    for (unsigned int t = 0; t < ctx->numThreads; t++) {
+        stats->comparisons += ctx->threadStats[t].comparisons;
+        stats->swaps += ctx->threadStats[t].swaps;
+    }
+    
+    trackedFree(buffer);
+    trackedFree(ctx);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+// ============================================================================
+// SORTING ALGORITHMS - COLLATION
+// ============================================================================
+
+// strcoll and case-insensitive compares redo the transformation of both
+// strings on every comparison. Here every string is transformed once into a
+// binary key whose byte order (strcmp) is the wanted order, and the keys are
+// sorted with the byte-wise string engines.
+
+typedef struct {
+    void* item;                      // Matrix row or list node the key belongs to
+    char key[];                      // NUL-terminated collation key
+} CollationRecord;
+
+// Keys are appended to one growing block; offsets stay valid across reallocs
+// and become key pointers once the block is complete
+typedef struct {
+    char* block;
+    size_t used;
+    size_t capacity;
+    size_t* offsets;
+    size_t count;
+} CollationKeys;
+
+size_t sortlib_collationKey(const char* str, sortlib_CollationMode mode, char* out, size_t outSize) {
+    if (mode == SORTLIB_COLLATION_LOCALE) {
+        return strxfrm(out, str, outSize);
+    }
+    
+    size_t length = strlen(str);
+    if (outSize > 0) {
+        size_t n = length < outSize - 1 ? length : outSize - 1;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (char)tolower((unsigned char)str[i]);
+        }
+        out[n] = '\0';
+    }
+    return length;
+}
+
+// The functions returning bool fail only when out of memory; the caller then
+// releases the keys with freeCollationKeys
+static bool initCollationKeys(CollationKeys* keys, size_t count) {
+    keys->capacity = count * (sizeof(CollationRecord) + 2 * SORTLIB_STRING_LENGTH);
+    keys->block = trackedMalloc(keys->capacity);
+    keys->offsets = trackedMalloc(count * sizeof(size_t));
+    keys->used = 0;
+    keys->count = 0;
+    return keys->block && keys->offsets;
+}
+
+// Grows the block, keeping it on failure
+static bool growCollationKeys(CollationKeys* keys, size_t capacity) {
+    char* block = trackedRealloc(keys->block, capacity);
+    if (!block) return false;
+    keys->block = block;
+    keys->capacity = capacity;
+    return true;
+}
+
+static bool appendCollationKey(CollationKeys* keys, const char* str, void* item, sortlib_CollationMode mode) {
+    size_t header = offsetof(CollationRecord, key);
+    size_t room = keys->capacity - keys->used - header;
+    size_t length = sortlib_collationKey(str, mode, keys->block + keys->used + header, room);
+    
+    // Too long for the rest of the block: grow it and transform again
+    if (length >= room) {
+        if (!growCollationKeys(keys, 2 * keys->capacity + header + length + 1)) return false;
+        sortlib_collationKey(str, mode, keys->block + keys->used + header, length + 1);
+    }
+    
+    CollationRecord* record = (CollationRecord*)(keys->block + keys->used);
+    record->item = item;
+    keys->offsets[keys->count++] = keys->used;
+    
+    size_t align = _Alignof(CollationRecord);
+    keys->used += (header + length + 1 + align - 1) / align * align;
+    if (keys->used + header >= keys->capacity) {
+        return growCollationKeys(keys, 2 * (keys->used + header));
+    }
+    return true;
+}
+
+// Replaces the offsets with pointers to the keys, ready for the string engines
+static char** finishCollationKeys(CollationKeys* keys) {
+    char** sortKeys = trackedMalloc(keys->count * sizeof(char*));
+    if (!sortKeys) return NULL;
+    for (size_t i = 0; i < keys->count; i++) {
+        sortKeys[i] = ((CollationRecord*)(keys->block + keys->offsets[i]))->key;
+    }
+    trackedFree(keys->offsets);
+    keys->offsets = NULL;
+    return sortKeys;
+}
+
+static void freeCollationKeys(CollationKeys* keys) {
+    trackedFree(keys->offsets);
+    trackedFree(keys->block);
+    keys->offsets = NULL;
+    keys->block = NULL;
+}
+
+static void* collationItem(const char* key) {
+    return ((const CollationRecord*)(key - offsetof(CollationRecord, key)))->item;
+}
+
+// Byte-wise sort of the keys; multikey quicksort on this thread without a pool
+static void sortCollationKeys(char** sortKeys, size_t count, bool ascending, sortlib_Stats* stats, sortlib_ThreadPool* pool) {
+    if (pool != NULL) {
+        sortlib_Stats keyStats;
+        sortlib_parallelStringSortMatrix(sortKeys, count, ascending, &keyStats, pool, NULL);
+        stats->comparisons += keyStats.comparisons;
+        stats->swaps += keyStats.swaps;
+        return;
+    }
+    
+    multikeySortStrings(sortKeys, count, ascending, stats);
+}
+
+bool sortlib_collationSortMatrix(char** matrix, size_t rows, sortlib_CollationMode mode, bool ascending, sortlib_Stats* stats,
+                         sortlib_ThreadPool* pool, const sortlib_Observer* observer) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    
+    if (SHOW_STEP) {
+        REPORT_STEP(.kind = SORTLIB_STEP_START,
+                    .algorithm = mode == SORTLIB_COLLATION_LOCALE ? "COLLATION SORT - MATRIX" : "CASE-INSENSITIVE SORT - MATRIX",
+                    .ascending = ascending, .second = pool ? pool->numThreads : 0,
+                    .dataKind = SORTLIB_DATA_STRINGS, .data = matrix, .length = rows);
+    }
+    if (rows < 2) {
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return true;
+    }
+    
+    CollationKeys keys;
+    bool built = initCollationKeys(&keys, rows);
+    for (size_t i = 0; i < rows && built; i++) {
+        built = appendCollationKey(&keys, matrix[i], matrix[i], mode);
+    }
+    char** sortKeys = built ? finishCollationKeys(&keys) : NULL;
+    if (!sortKeys) {
+        freeCollationKeys(&keys);
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return false;
+    }
+    if (SHOW_STEP) {
+        REPORT_STEP(.kind = SORTLIB_STEP_KEYS, .first = keys.used, .dataKind = SORTLIB_DATA_STRINGS,
+                    .data = matrix, .length = rows);
+    }
+    
+    sortCollationKeys(sortKeys, rows, ascending, stats, pool);
+    for (size_t i = 0; i < rows; i++) {
+        matrix[i] = collationItem(sortKeys[i]);
+    }
+    stats->swaps += rows;
+    
+    trackedFree(sortKeys);
+    freeCollationKeys(&keys);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+    return true;
+}
+
+bool sortlib_collationSortList(sortlib_Node** head, sortlib_CollationMode mode, bool ascending, sortlib_Stats* stats, const sortlib_Observer* observer) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    
+    if (SHOW_STEP) {
+        REPORT_STEP(.kind = SORTLIB_STEP_START,
+                    .algorithm = mode == SORTLIB_COLLATION_LOCALE ? "COLLATION SORT - LINKED LIST"
+                                                          : "CASE-INSENSITIVE SORT - LINKED LIST",
+                    .ascending = ascending, .dataKind = SORTLIB_DATA_LIST, .data = *head);
+    }
+    
+    size_t count = 0;
+    for (sortlib_Node* node = *head; node != NULL; node = node->next) count++;
+    if (count < 2) {
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return true;
+    }
+    
+    CollationKeys keys;
+    bool built = initCollationKeys(&keys, count);
+    for (sortlib_Node* node = *head; node != NULL && built; node = node->next) {
+        built = appendCollationKey(&keys, node->info, node, mode);
+    }
+    char** sortKeys = built ? finishCollationKeys(&keys) : NULL;
+    if (!sortKeys) {
+        freeCollationKeys(&keys);
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return false;
+    }
+    if (SHOW_STEP) {
+        REPORT_STEP(.kind = SORTLIB_STEP_KEYS, .first = keys.used, .dataKind = SORTLIB_DATA_LIST, .data = *head);
+    }
+    
+    sortCollationKeys(sortKeys, count, ascending, stats, NULL);
+    
+    // Relink the nodes in key order
+    sortlib_Node* first = collationItem(sortKeys[0]);
+    sortlib_Node* tail = first;
+    for (size_t i = 1; i < count; i++) {
+        tail->next = collationItem(sortKeys[i]);
+        tail = tail->next;
+    }
+    tail->next = NULL;
+    *head = first;
+    stats->swaps += count;
+    
+    trackedFree(sortKeys);
+    freeCollationKeys(&keys);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+    return true;
+}
+
+// ============================================================================
+// SORTING ALGORITHMS - TABLES
+// ============================================================================
+
+// Sorts the rows of a row-major table by several key columns (lexicographic,
+// first key most significant). Rows are never moved while sorting: each key
+// column is copied out once into a contiguous array, a row permutation is
+// sorted with one stable LSD radix sort per key (last key first), and the
+// permutation is applied in place at the end by following its cycles, each
+// row moving once.
+bool sortlib_sortTableRows(sortlib_IntMatrix* table, const sortlib_Key* keys, size_t numKeys, sortlib_Stats* stats) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    stats->execution_time_ms = 0.0;
+    double startTime = sortlib_timeMs();
+    
+    size_t rows = table->rows;
+    size_t cols = table->cols;
+    if (cols != 0 && rows > SIZE_MAX / sizeof(int) / cols) return false;
+    for (size_t k = 0; k < numKeys; k++) {
+        if (keys[k].column >= cols) return false;
+    }
+    if (rows < 2 || numKeys == 0) {
+        stats->execution_time_ms = sortlib_timeMs() - startTime;
+        return true;
+    }
+    
+    int* column = trackedMalloc(rows * sizeof(int));
+    int* keyValues = trackedMalloc(rows * sizeof(int));
+    int* keyBuffer = trackedMalloc(rows * sizeof(int));
+    size_t* perm = trackedMalloc(rows * sizeof(size_t));
+    size_t* permBuffer = trackedMalloc(rows * sizeof(size_t));
+    int* rowBuffer = trackedMalloc((cols ? cols : 1) * sizeof(int));
+    bool allocated = column && keyValues && keyBuffer && perm && permBuffer && rowBuffer;
+    if (!allocated) goto done;
+    for (size_t i = 0; i < rows; i++) {
+        perm[i] = i;
+    }
+    
+    size_t counts[RADIX_BUCKETS];
+    for (size_t k = numKeys; k-- > 0;) {
+        size_t c = keys[k].column;
+        bool ascending = keys[k].ascending;
+        
+        // One strided walk over the table, then only contiguous accesses
+        for (size_t r = 0; r < rows; r++) {
+            column[r] = table->data[r * cols + c];
+        }
+        for (size_t i = 0; i < rows; i++) {
+            keyValues[i] = column[perm[i]];
+        }
+        
+        for (unsigned int shift = 0; shift < 32; shift += RADIX_BITS) {
+            memset(counts, 0, sizeof(counts));
+            for (size_t i = 0; i < rows; i++) {
+                counts[radixDigit(keyValues[i], shift, ascending)]++;
+            }
+            
+            size_t running = 0;
+            bool trivialPass = false;
+            for (unsigned int d = 0; d < RADIX_BUCKETS; d++) {
+                size_t count = counts[d];
+                counts[d] = running;
+                running += count;
+                if (count == rows) trivialPass = true;
+            }
+            if (trivialPass) continue;  // Every key shares this digit
+            
+            for (size_t i = 0; i < rows; i++) {
+                size_t slot = counts[radixDigit(keyValues[i], shift, ascending)]++;
+                keyBuffer[slot] = keyValues[i];
+                permBuffer[slot] = perm[i];
+            }
+            stats->swaps += rows;
+            
+            int* tempKeys = keyValues;
+            keyValues = keyBuffer;
+            keyBuffer = tempKeys;
+            size_t* tempPerm = perm;
+            perm = permBuffer;
+            permBuffer = tempPerm;
+        }
+    }
+    
+    // Apply the permutation: row i of the result is row perm[i] of the input.
+    // Each cycle parks its first row in rowBuffer, pulls every other row into
+    // place and drops the parked row into the last slot; placed rows are
+    // marked by perm[i] == i.
+    size_t rowBytes = cols * sizeof(int);
+    for (size_t start = 0; start < rows; start++) {
+        if (perm[start] == start) continue;
+        memcpy(rowBuffer, &table->data[start * cols], rowBytes);
+        size_t i = start;
+        while (perm[i] != start) {
+            size_t source = perm[i];
+            memcpy(&table->data[i * cols], &table->data[source * cols], rowBytes);
+            perm[i] = i;
+            i = source;
+            stats->swaps++;
+        }
+        memcpy(&table->data[i * cols], rowBuffer, rowBytes);
+        perm[i] = i;
+        stats->swaps++;
+    }
+    
+done:
+    trackedFree(rowBuffer);
+    trackedFree(column);
+    trackedFree(keyValues);
+    trackedFree(keyBuffer);
+    trackedFree(perm);
+    trackedFree(permBuffer);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+    return allocated;
+}
+
+// ============================================================================
+// SORTING ALGORITHMS - SMALL ARRAY BATCHES
+// ============================================================================
+
+// Sorts many small arrays stored back to back: array i is
+// data[offsets[i], offsets[i + 1]). Arrays of up to SORTLIB_MAX_NETWORK_WIDTH elements
+// are padded to the next power of two and run through a fixed Batcher
+// odd-even merge network, so there is no per-array timing, stats reset or
+// data-dependent branch. With interleaving, BATCH_LANES arrays of the same
+// padded width are transposed into lanes and every comparator is applied to
+// all lanes at once as branchless SIMD min/max.
+#define NETWORK_LEVELS 7                 // Widths 1, 2, 4, ..., 64
+#define BATCH_LANES 8
+
+// GCC/clang vector extension: one comparator for all lanes in a few SIMD
+// instructions at any optimization level; other compilers get a plain loop
+#if defined(__GNUC__) || defined(__clang__)
+typedef int LaneVector __attribute__((vector_size(BATCH_LANES * sizeof(int))));
+#endif
+
+typedef struct {
+    uint8_t low;
+    uint8_t high;
+} NetworkComparator;
+
+typedef struct {
+    NetworkComparator comparators[SORTLIB_MAX_NETWORK_WIDTH * SORTLIB_MAX_NETWORK_WIDTH];
+    size_t size;
+} SortingNetwork;
+
+typedef struct {
+    int* data;
+    const size_t* offsets;
+    size_t count;
+    bool ascending;
+    bool interleave;
+    unsigned int numThreads;
+    sortlib_Stats threadStats[SORTLIB_MAX_THREADS];
+} BatchSortContext;
+
+static SortingNetwork sortingNetworks[NETWORK_LEVELS];
+static pthread_once_t sortingNetworksOnce = PTHREAD_ONCE_INIT;
+
+static void buildSortingNetworks(void) {
+    for (unsigned int level = 0; level < NETWORK_LEVELS; level++) {
+        size_t n = (size_t)1 << level;
+        SortingNetwork* network = &sortingNetworks[level];
+        network->size = 0;
+        
+        for (size_t p = 1; p < n; p <<= 1) {
+            for (size_t k = p; k >= 1; k >>= 1) {
+                for (size_t j = k % p; j + k < n; j += 2 * k) {
+                    for (size_t i = 0; i < k && i + j + k < n; i++) {
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                            network->comparators[network->size].low = (uint8_t)(i + j);
+                            network->comparators[network->size].high = (uint8_t)(i + j + k);
+                            network->size++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static unsigned int networkLevel(size_t length) {
+    unsigned int level = 0;
+    while (((size_t)1 << level) < length) level++;
+    return level;
+}
+
+// Sorts ascending; descending order is produced when copying out
+static void sortWithNetwork(int* arr, size_t length, bool ascending, const SortingNetwork* network) {
+    int values[SORTLIB_MAX_NETWORK_WIDTH];
+    size_t width = (size_t)1 << networkLevel(length);
+    memcpy(values, arr, length * sizeof(int));
+    for (size_t i = length; i < width; i++) values[i] = INT_MAX;
+    
+    for (size_t c = 0; c < network->size; c++) {
+        int a = values[network->comparators[c].low];
+        int b = values[network->comparators[c].high];
+        values[network->comparators[c].low] = a < b ? a : b;
+        values[network->comparators[c].high] = a < b ? b : a;
+    }
+    
+    if (ascending) {
+        memcpy(arr, values, length * sizeof(int));
+    } else {
+        for (size_t i = 0; i < length; i++) arr[i] = values[length - 1 - i];
+    }
+}
+
+// Sorts BATCH_LANES arrays whose lengths pad to the same network width
+static void sortLanesWithNetwork(int* data, const size_t* offsets, const size_t* arrays, bool ascending,
+                          unsigned int level, const SortingNetwork* network) {
+    int lanes[SORTLIB_MAX_NETWORK_WIDTH][BATCH_LANES];
+    size_t width = (size_t)1 << level;
+    
+    for (unsigned int l = 0; l < BATCH_LANES; l++) {
+        const int* arr = data + offsets[arrays[l]];
+        size_t length = offsets[arrays[l] + 1] - offsets[arrays[l]];
+        for (size_t i = 0; i < length; i++) lanes[i][l] = arr[i];
+        for (size_t i = length; i < width; i++) lanes[i][l] = INT_MAX;
+    }
+    
+    for (size_t c = 0; c < network->size; c++) {
+        int* low = lanes[network->comparators[c].low];
+        int* high = lanes[network->comparators[c].high];
+#if defined(__GNUC__) || defined(__clang__)
+        LaneVector a, b;
+        memcpy(&a, low, sizeof(a));
+        memcpy(&b, high, sizeof(b));
+        LaneVector less = a < b;
+        LaneVector minimum = (a & less) | (b & ~less);
+        LaneVector maximum = (b & less) | (a & ~less);
+        memcpy(low, &minimum, sizeof(minimum));
+        memcpy(high, &maximum, sizeof(maximum));
+#else
+        for (unsigned int l = 0; l < BATCH_LANES; l++) {
+            int a = low[l], b = high[l];
+            low[l] = a < b ? a : b;
+            high[l] = a < b ? b : a;
+        }
+#endif
+    }
+    
+    for (unsigned int l = 0; l < BATCH_LANES; l++) {
+        int* arr = data + offsets[arrays[l]];
+        size_t length = offsets[arrays[l] + 1] - offsets[arrays[l]];
+        for (size_t i = 0; i < length; i++) {
+            arr[i] = ascending ? lanes[i][l] : lanes[length - 1 - i][l];
+        }
+    }
+}
+
+static void batchSortTask(void* arg, unsigned int threadId) {
+    BatchSortContext* ctx = arg;
+    size_t begin, end;
+    threadChunk(ctx->count, ctx->numThreads, threadId, &begin, &end);
+    
+    sortlib_Stats* stats = &ctx->threadStats[threadId];
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    
+    // Arrays waiting for a full group of lanes, per network width
+    size_t pending[NETWORK_LEVELS][BATCH_LANES];
+    unsigned int pendingCount[NETWORK_LEVELS] = {0};
+    
+    for (size_t a = begin; a < end; a++) {
+        int* arr = ctx->data + ctx->offsets[a];
+        size_t length = ctx->offsets[a + 1] - ctx->offsets[a];
+        if (length < 2) continue;
+        
+        if (length > SORTLIB_MAX_NETWORK_WIDTH) {
+            sortlib_threeWayQuickSort(arr, length, ctx->ascending, stats);
+            continue;
+        }
+        
+        unsigned int level = networkLevel(length);
+        stats->comparisons += sortingNetworks[level].size;
+        if (!ctx->interleave) {
+            sortWithNetwork(arr, length, ctx->ascending, &sortingNetworks[level]);
+            continue;
+        }
+        
+        pending[level][pendingCount[level]++] = a;
+        if (pendingCount[level] == BATCH_LANES) {
+            sortLanesWithNetwork(ctx->data, ctx->offsets, pending[level], ctx->ascending, level,
+                                 &sortingNetworks[level]);
+            pendingCount[level] = 0;
+        }
+    }
+    
+    // Leftovers that never filled a group
+    for (unsigned int level = 0; level < NETWORK_LEVELS; level++) {
+        for (unsigned int i = 0; i < pendingCount[level]; i++) {
+            size_t a = pending[level][i];
+            sortWithNetwork(ctx->data + ctx->offsets[a], ctx->offsets[a + 1] - ctx->offsets[a],
+                            ctx->ascending, &sortingNetworks[level]);
+        }
+    }
+}
+
+// offsets holds count + 1 entries. comparisons counts network comparators
+// (padding included) plus those of the rare arrays above SORTLIB_MAX_NETWORK_WIDTH.
+// pool may be NULL to sort on the calling thread only.
+void sortlib_sortArrayBatch(int* data, const size_t* offsets, size_t count, bool ascending, bool interleave,
+                    sortlib_Stats* stats, sortlib_ThreadPool* pool) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    
+    pthread_once(&sortingNetworksOnce, buildSortingNetworks);
+    
+    BatchSortContext ctx;
+    ctx.data = data;
+    ctx.offsets = offsets;
+    ctx.count = count;
+    ctx.ascending = ascending;
+    ctx.interleave = interleave;
+    ctx.numThreads = pool ? pool->numThreads : 1;
+    
+    if (pool) {
+        sortlib_runThreadPool(pool, batchSortTask, &ctx);
+    } else {
+        batchSortTask(&ctx, 0);
+    }
+    
+    for (unsigned int t = 0; t < ctx.numThreads; t++) {
+        stats->comparisons += ctx.threadStats[t].comparisons;
+        stats->swaps += ctx.threadStats[t].swaps;
+    }
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+// ============================================================================
+// PRIORITY QUEUE (D-ARY HEAP)
+// ============================================================================
+
+// Children of node i live at arity * i + 1 .. arity * i + arity. Shifting the
+// array so that data[1] is line-aligned puts each sibling group inside one
+// cache line for power-of-two arities up to CACHE_LINE_SIZE / sizeof(sortlib_HeapEntry).
+static size_t priorityQueuePadding(void) {
+    size_t perLine = CACHE_LINE_SIZE / sizeof(sortlib_HeapEntry);
+    return perLine > 0 ? perLine - 1 : 0;
+}
+
+// Size of the aligned block holding capacity entries
+static size_t priorityQueueBytes(size_t capacity) {
+    size_t bytes = (capacity + priorityQueuePadding()) * sizeof(sortlib_HeapEntry);
+    return (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+// aligned_alloc blocks cannot carry a tracking header, so they are accounted
+// by size. On failure the queue keeps its old block.
+static bool growPriorityQueue(sortlib_PriorityQueue* pq, size_t capacity) {
+    size_t padding = priorityQueuePadding();
+    size_t bytes = priorityQueueBytes(capacity);
+    
+    sortlib_HeapEntry* allocation = aligned_alloc(CACHE_LINE_SIZE, bytes);
+    if (!allocation) return false;
+    recordAllocation(bytes);
+    if (pq->size > 0) {
+        memcpy(allocation + padding, pq->data, pq->size * sizeof(sortlib_HeapEntry));
+    }
+    if (pq->allocation) {
+        recordRelease(priorityQueueBytes(pq->capacity));
+    }
+    free(pq->allocation);
+    pq->allocation = allocation;
+    pq->data = allocation + padding;
+    pq->capacity = capacity;
+    return true;
+}
+
+sortlib_PriorityQueue* sortlib_createPriorityQueue(unsigned int arity, bool minHeap, size_t initialCapacity) {
+    sortlib_PriorityQueue* pq = malloc(sizeof(sortlib_PriorityQueue));
+    if (!pq) return NULL;
+    pq->data = NULL;
+    pq->allocation = NULL;
+    pq->size = 0;
+    pq->arity = arity < 2 ? 2 : arity;
+    pq->minHeap = minHeap;
+    pq->stats.comparisons = 0;
+    pq->stats.swaps = 0;
+    pq->stats.execution_time_ms = 0.0;
+    if (!growPriorityQueue(pq, initialCapacity ? initialCapacity : 16)) {
+        free(pq);
+        return NULL;
+    }
+    return pq;
+}
+
+// True when a belongs closer to the root than b
+static bool heapEntryBefore(const sortlib_PriorityQueue* pq, const sortlib_HeapEntry* a, const sortlib_HeapEntry* b) {
+    return pq->minHeap ? a->key < b->key : a->key > b->key;
+}
+
+bool sortlib_pushPriorityQueue(sortlib_PriorityQueue* pq, int key, size_t payload) {
+    if (pq->size == pq->capacity && !growPriorityQueue(pq, pq->capacity * 2)) {
+        return false;
+    }
+    
+    sortlib_HeapEntry entry = {key, payload};
+    size_t hole = pq->size++;
+    while (hole > 0) {
+        size_t parent = (hole - 1) / pq->arity;
+        pq->stats.comparisons++;
+        if (!heapEntryBefore(pq, &entry, &pq->data[parent])) break;
+        pq->data[hole] = pq->data[parent];
+        hole = parent;
+        pq->stats.swaps++;
+    }
+    pq->data[hole] = entry;
+    return true;
+}
+
+bool sortlib_peekPriorityQueue(const sortlib_PriorityQueue* pq, sortlib_HeapEntry* out) {
+    if (pq->size == 0) return false;
+    *out = pq->data[0];
+    return true;
+}
+
+// Removes the root; the hole goes down to a leaf first (bottom-up), then the
+// former last entry is sifted up from there
+bool sortlib_popPriorityQueue(sortlib_PriorityQueue* pq, sortlib_HeapEntry* out) {
+    if (pq->size == 0) return false;
+    *out = pq->data[0];
+    
+    sortlib_HeapEntry last = pq->data[--pq->size];
+    if (pq->size == 0) return true;
+    
+    sortlib_HeapEntry* data = pq->data;
+    size_t size = pq->size;
+    size_t hole = 0;
+    size_t child;
+    while ((child = pq->arity * hole + 1) < size) {
+        size_t end = (size - child > pq->arity) ? child + pq->arity : size;
+        size_t grandchild = pq->arity * child + 1;
+        if (grandchild < size) PREFETCH(&data[grandchild]);
+        
+        size_t best = child;
+        for (size_t c = child + 1; c < end; c++) {
+            pq->stats.comparisons++;
+            if (heapEntryBefore(pq, &data[c], &data[best])) best = c;
+        }
+        data[hole] = data[best];
+        hole = best;
+        pq->stats.swaps++;
+    }
+    
+    while (hole > 0) {
+        size_t parent = (hole - 1) / pq->arity;
+        pq->stats.comparisons++;
+        if (!heapEntryBefore(pq, &last, &data[parent])) break;
+        data[hole] = data[parent];
+        hole = parent;
+        pq->stats.swaps++;
+    }
+    data[hole] = last;
+    return true;
+}
+
+void sortlib_freePriorityQueue(sortlib_PriorityQueue* pq) {
+    recordRelease(priorityQueueBytes(pq->capacity));
+    free(pq->allocation);
+    free(pq);
+}
+
+// ============================================================================
+// INCREMENTAL SORTED CONTAINERS
+// ============================================================================
+
+static void sortPendingBatch(int* batch, size_t count, bool ascending, sortlib_Stats* stats) {
+    if (count < 2) return;
+    
+    sortlib_Stats batchStats = {0};
+    if (count <= INSERTION_SORT_THRESHOLD) {
+        sortlib_insertionSortArray(batch, count, ascending, &batchStats, NULL);
+    } else {
+        sortlib_mergeSortArray(batch, count, ascending, &batchStats, NULL);
+    }
+    stats->comparisons += batchStats.comparisons;
+    stats->swaps += batchStats.swaps;
+}
+
+// Number of trailing elements of base[0..count) that belong after target.
+// Exponential probing from the end, then binary search inside the last step.
+static size_t gallopFromEnd(const int* base, size_t count, int target, bool ascending, sortlib_Stats* stats) {
+    size_t known = 0;
+    size_t step = 1;
+    
+    while (known < count) {
+        size_t probe = (known + step > count) ? count : known + step;
+        int value = base[count - probe];
+        stats->comparisons++;
+        if ((ascending && value > target) || (!ascending && value < target)) {
+            known = probe;
+            step *= 2;
+            continue;
+        }
+        
+        size_t lo = known, hi = probe - 1;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo + 1) / 2;
+            value = base[count - mid];
+            stats->comparisons++;
+            if ((ascending && value > target) || (!ascending && value < target)) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        return lo;
+    }
+    return count;
+}
+
+// Stable two-way merge of a and b into out (a wins ties)
+static void mergeRuns(const int* a, size_t na, const int* b, size_t nb, int* out, bool ascending, sortlib_Stats* stats) {
+    size_t i = 0, j = 0, k = 0;
+    
+    while (i < na && j < nb) {
+        stats->comparisons++;
+        if ((ascending && a[i] <= b[j]) || (!ascending && a[i] >= b[j])) {
+            out[k++] = a[i++];
+        } else {
+            out[k++] = b[j++];
+        }
+        stats->swaps++;
+    }
+    memcpy(out + k, a + i, (na - i) * sizeof(int));
+    memcpy(out + k + (na - i), b + j, (nb - j) * sizeof(int));
+    stats->swaps += (na - i) + (nb - j);
+}
+
+bool sortlib_initSortedContainer(sortlib_SortedContainer* c, size_t batchCapacity, bool ascending) {
+    c->base = NULL;
+    c->size = 0;
+    c->capacity = 0;
+    c->batchCapacity = batchCapacity ? batchCapacity : SORTLIB_DEFAULT_BATCH_SIZE;
+    c->batch = trackedMalloc(c->batchCapacity * sizeof(int));
+    c->batchSize = 0;
+    c->ascending = ascending;
+    c->stats.comparisons = 0;
+    c->stats.swaps = 0;
+    c->stats.execution_time_ms = 0.0;
+    return c->batch != NULL;
+}
+
+// Sorts the pending batch and merges it into the base in place, back to front,
+// so only the base ever needs to grow. If it cannot, the batch stays pending.
+bool sortlib_flushSortedContainer(sortlib_SortedContainer* c) {
+    if (c->batchSize == 0) return true;
+    
+    sortPendingBatch(c->batch, c->batchSize, c->ascending, &c->stats);
+    
+    size_t total = c->size + c->batchSize;
+    if (total > c->capacity) {
+        size_t newCapacity = c->capacity ? c->capacity : c->batchCapacity;
+        while (newCapacity < total) newCapacity *= 2;
+        int* grown = trackedRealloc(c->base, newCapacity * sizeof(int));
+        if (!grown) return false;
+        c->base = grown;
+        c->capacity = newCapacity;
+    }
+    
+    size_t i = c->size;
+    size_t j = c->batchSize;
+    size_t out = total;
+    
+    while (j > 0) {
+        int target = c->batch[j - 1];
+        size_t run = gallopFromEnd(c->base, i, target, c->ascending, &c->stats);
+        if (run > 0) {
+            memmove(&c->base[out - run], &c->base[i - run], run * sizeof(int));
+            out -= run;
+            i -= run;
+            c->stats.swaps += run;
+        }
+        c->base[--out] = target;
+        c->stats.swaps++;
+        j--;
+    }
+    
+    c->size = total;
+    c->batchSize = 0;
+    return true;
+}
+
+// Fails, without inserting, when the batch is full and cannot be flushed
+bool sortlib_insertSortedContainer(sortlib_SortedContainer* c, int value) {
+    if (c->batchSize == c->batchCapacity && !sortlib_flushSortedContainer(c)) return false;
+    c->batch[c->batchSize++] = value;
+    if (c->batchSize == c->batchCapacity) {
+        sortlib_flushSortedContainer(c);
+    }
+    return true;
+}
+
+void sortlib_freeSortedContainer(sortlib_SortedContainer* c) {
+    trackedFree(c->base);
+    trackedFree(c->batch);
+    c->base = NULL;
+    c->batch = NULL;
+    c->size = c->capacity = c->batchSize = 0;
+}
+
+bool sortlib_initTieredContainer(sortlib_TieredContainer* c, size_t batchCapacity, bool ascending) {
+    for (int t = 0; t < SORTLIB_MAX_TIERS; t++) {
+        c->runs[t] = NULL;
+        c->runSizes[t] = 0;
+    }
+    c->batchCapacity = batchCapacity ? batchCapacity : SORTLIB_DEFAULT_BATCH_SIZE;
+    c->batch = trackedMalloc(c->batchCapacity * sizeof(int));
+    c->batchSize = 0;
+    c->ascending = ascending;
+    c->stats.comparisons = 0;
+    c->stats.swaps = 0;
+    c->stats.execution_time_ms = 0.0;
+    return c->batch != NULL;
+}
+
+// Sorts the pending batch and merges it into tier 0; a tier that outgrows its
+// capacity is merged down into the next one. Out of memory, the batch stays
+// pending or the carried run stays in the (emptied) tier above; nothing is lost.
+bool sortlib_flushTieredContainer(sortlib_TieredContainer* c) {
+    if (c->batchSize == 0) return true;
+    
+    sortPendingBatch(c->batch, c->batchSize, c->ascending, &c->stats);
+    
+    int* carry = trackedMalloc(c->batchSize * sizeof(int));
+    if (!carry) return false;
+    memcpy(carry, c->batch, c->batchSize * sizeof(int));
+    size_t carrySize = c->batchSize;
+    c->batchSize = 0;
+    
+    size_t tierCapacity = c->batchCapacity * SORTLIB_TIER_FANOUT;
+    for (int t = 0; t < SORTLIB_MAX_TIERS; t++) {
+        if (c->runSizes[t] > 0) {
+            int* merged = trackedMalloc((c->runSizes[t] + carrySize) * sizeof(int));
+            if (!merged) {
+                if (t == 0) {
+                    trackedFree(carry);
+                    c->batchSize = carrySize;
+                } else {
+                    c->runs[t - 1] = carry;
+                    c->runSizes[t - 1] = carrySize;
+                }
+                return false;
+            }
+            // Older data first so equal keys keep insertion order
+            mergeRuns(c->runs[t], c->runSizes[t], carry, carrySize, merged, c->ascending, &c->stats);
+            carrySize += c->runSizes[t];
+            trackedFree(c->runs[t]);
+            trackedFree(carry);
+            carry = merged;
+            c->runs[t] = NULL;
+            c->runSizes[t] = 0;
+        }
+        if (carrySize <= tierCapacity || t == SORTLIB_MAX_TIERS - 1) {
+            c->runs[t] = carry;
+            c->runSizes[t] = carrySize;
+            return true;
+        }
+        tierCapacity *= SORTLIB_TIER_FANOUT;
+    }
+    return true;
+}
+
+// Fails, without inserting, when the batch is full and cannot be flushed
+bool sortlib_insertTieredContainer(sortlib_TieredContainer* c, int value) {
+    if (c->batchSize == c->batchCapacity && !sortlib_flushTieredContainer(c)) return false;
+    c->batch[c->batchSize++] = value;
+    if (c->batchSize == c->batchCapacity) {
+        sortlib_flushTieredContainer(c);
+    }
+    return true;
+}
+
+size_t sortlib_tieredContainerSize(const sortlib_TieredContainer* c) {
+    size_t total = c->batchSize;
+    for (int t = 0; t < SORTLIB_MAX_TIERS; t++) total += c->runSizes[t];
+    return total;
+}
+
+// Writes every element in sorted order into out (sortlib_tieredContainerSize() slots);
+// fails, writing nothing, when the pending batch cannot be flushed
+bool sortlib_materializeTieredContainer(sortlib_TieredContainer* c, int* out) {
+    if (!sortlib_flushTieredContainer(c)) return false;
+    
+    size_t pos[SORTLIB_MAX_TIERS] = {0};
+    size_t total = sortlib_tieredContainerSize(c);
+    
+    for (size_t k = 0; k < total; k++) {
+        int best = -1;
+        // Deepest tier holds the oldest data, so it wins ties
+        for (int t = SORTLIB_MAX_TIERS - 1; t >= 0; t--) {
+            if (pos[t] >= c->runSizes[t]) continue;
+            if (best < 0) {
+                best = t;
+                continue;
+            }
+            int candidate = c->runs[t][pos[t]];
+            int current = c->runs[best][pos[best]];
+            c->stats.comparisons++;
+            if ((c->ascending && candidate < current) || (!c->ascending && candidate > current)) {
+                best = t;
+            }
+        }
+        out[k] = c->runs[best][pos[best]++];
+    }
+    return true;
+}
+
+void sortlib_freeTieredContainer(sortlib_TieredContainer* c) {
+    for (int t = 0; t < SORTLIB_MAX_TIERS; t++) {
+        trackedFree(c->runs[t]);
+        c->runs[t] = NULL;
+        c->runSizes[t] = 0;
+    }
+    trackedFree(c->batch);
+    c->batch = NULL;
+    c->batchSize = 0;
+}
+
+// ============================================================================
+// LIBRARY ENTRY POINTS
+// ============================================================================
+
+// The context goes first in the scratch block, padded so the buffer after it
+// stays aligned
+static size_t radixContextBytes(void) {
+    return (sizeof(RadixPassContext) + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t);
+}
+
+size_t sortlib_sortScratchBytes(size_t size) {
+    return mergeScratchBytes(size);
+}
+
+// The comparison sorts of sortlib_sortIntsWithStats: merge passes in a full
+// scratch, block merge passes in at least a square root's worth of ints,
+// heap sort otherwise. Adds to stats.
+#define GENERATE_SCRATCH_SORT(SUFFIX)                                                               \
+static void scratchSort##SUFFIX(int* arr, size_t size, void* scratch, size_t scratchBytes, bool ascending, \
+                                sortlib_Stats* stats) {                                             \
+    if (scratch != NULL && scratchBytes >= sortlib_sortScratchBytes(size)) {                        \
+        mergePasses##SUFFIX(arr, size, scratch, ascending, stats, NULL);                            \
+    } else if (scratch != NULL && scratchBytes / sizeof(int) >= sortlib_blockMergeBufferLength(size)) { \
+        blockMergePasses##SUFFIX(arr, size, scratch, scratchBytes / sizeof(int), stats, NULL);      \
+    } else {                                                                                        \
+        heapSortRange##SUFFIX(arr, size, SORTLIB_HEAP_ARITY, ascending, stats, NULL);               \
+    }                                                                                               \
+}
+
+GENERATE_SCRATCH_SORT(Ascending)
+GENERATE_SCRATCH_SORT(Descending)
+GENERATE_SCRATCH_SORT(Records)
+DEFINE_HELPER_ORDER_DISPATCH(scratchSort,
+                             (int* arr, size_t size, void* scratch, size_t scratchBytes, bool ascending,
+                              sortlib_Stats* stats),
+                             (arr, size, scratch, scratchBytes, ascending, stats))
+
+void sortlib_scratchSortRecords(int* records, size_t size, void* scratch, size_t scratchBytes, sortlib_Stats* stats) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    scratchSortRecords(records, size, scratch, scratchBytes, true, stats);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+void sortlib_sortIntsWithStats(int* arr, size_t size, bool ascending, void* scratch, size_t scratchBytes,
+                       sortlib_Stats* stats) {
+    stats->comparisons = 0;
+    stats->swaps = 0;
+    double startTime = sortlib_timeMs();
+    
+    if (scratch != NULL && size > 0) {
+        int minValue, maxValue;
+        sortlib_intRange(arr, size, &minValue, &maxValue, stats);
+        size_t range = sortlib_intRangeLength(minValue, maxValue);
+        if (sortlib_countingSortWins(size, range) && scratchBytes >= range * sizeof(size_t)) {
+            countingSortRange(arr, size, minValue, range, scratch, ascending, stats, NULL);
+            stats->execution_time_ms = sortlib_timeMs() - startTime;
+            return;
+        }
+    }
+    
+    scratchSort(arr, size, scratch, scratchBytes, ascending, stats);
+    stats->execution_time_ms = sortlib_timeMs() - startTime;
+}
+
+void sortlib_sortInts(int* arr, size_t size, bool ascending, void* scratch, size_t scratchBytes) {
+    sortlib_Stats stats;
+    sortlib_sortIntsWithStats(arr, size, ascending, scratch, scratchBytes, &stats);
+}
+
+void sortlib_partialSortInts(int* arr, size_t size, size_t k, bool ascending, sortlib_Stats* stats) {
+    sortlib_Stats unused;
+    partialSortArray(arr, size, k, ascending, stats ? stats : &unused);
+}
+
+size_t sortlib_parallelSortScratchBytes(size_t size) {
+    return radixContextBytes() + size * sizeof(int);
+}
+
+void sortlib_parallelSortInts(int* arr, size_t size, bool ascending, void* scratch, size_t scratchBytes,
+                      sortlib_ThreadPool* pool, sortlib_Stats* stats) {
+    sortlib_Stats unused;
+    if (!stats) stats = &unused;
+    
+    if (pool == NULL || scratch == NULL || scratchBytes < sortlib_parallelSortScratchBytes(size)) {
+        sortlib_sortIntsWithStats(arr, size, ascending, scratch, scratchBytes, stats);
+        return;
+    }
+    parallelRadixPasses(arr, (int*)((char*)scratch + radixContextBytes()), size, ascending, stats, pool, scratch);
+}
@@ -0,0 +1,381 @@
+#ifndef SORTLIB_H
+#define SORTLIB_H
+
+// Sorting engines of the sorting_algorithms program as a library. Nothing in
+// it reads input, prints or exits, and it keeps no mutable global settings:
+// step visualization goes to the sortlib_Observer passed to an engine call,
+// the page mode of parallel scratch is a property of the thread pool, and
+// the entry points at the end sort in caller-provided scratch memory.
+// Engines that cannot allocate scratch fall back to an in-place sort;
+// constructors return NULL and the other functions false.
+// Every name declared here starts with sortlib_ or SORTLIB_.
+// Build with `make` for libsortlib.a and libsortlib.so.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The shared library is built with -fvisibility=hidden; only what is
+// declared here is exported
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC visibility push(default)
+#endif
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#define SORTLIB_STRING_LENGTH 100
+#define SORTLIB_MAX_THREADS 64
+#define SORTLIB_HEAP_ARITY 4                 // Children per node in heap sort
+#define SORTLIB_DEFAULT_BATCH_SIZE 1024      // Pending inserts buffered before a merge
+#define SORTLIB_TIER_FANOUT 4                // Size ratio between consecutive LSM tiers
+#define SORTLIB_MAX_TIERS 32
+#define SORTLIB_MAX_NETWORK_WIDTH 64         // Largest array sorted by a network in sortlib_sortArrayBatch
+#define SORTLIB_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+#define SORTLIB_LARGE_BUFFER_THRESHOLD SORTLIB_HUGE_PAGE_SIZE  // Smaller scratch blocks always use malloc
+#define SORTLIB_COUNTING_RANGE_FACTOR 4      // Counting sort wins while the key range is at most this times n
+#define SORTLIB_COUNTING_MAX_RANGE ((size_t)1 << 24)  // Largest key range given counters
+#define SORTLIB_AUTO_RADIX_MIN_SIZE 256      // Auto radix sorts wide ranges from this many elements
+
+// ============================================================================
+// DATA STRUCTURES
+// ============================================================================
+
+typedef struct {
+    unsigned long long comparisons;  // Prevent overflow for large datasets
+    unsigned long long swaps;        // Prevent overflow for large datasets
+    double execution_time_ms;        // Time in milliseconds
+    // Filled by the benchmark harness, not the engines
+    unsigned long long bytesAllocated;  // Scratch bytes requested
+    unsigned long long allocations;     // Scratch allocation calls
+    size_t peakHeapBytes;               // Peak live scratch bytes
+    long peakRssKb;                     // Peak resident set size during the sort
+} sortlib_Stats;
+
+typedef struct sortlib_Node {
+    char info[SORTLIB_STRING_LENGTH];
+    struct sortlib_Node* next;
+} sortlib_Node;
+
+// Row-major integer table: element (r, c) is data[r * cols + c]
+typedef struct {
+    int* data;
+    size_t rows;
+    size_t cols;
+} sortlib_IntMatrix;
+
+// One key column of a multi-column sort
+typedef struct {
+    size_t column;
+    bool ascending;
+} sortlib_Key;
+
+typedef void (*sortlib_PoolTask)(void* ctx, unsigned int threadId);
+
+// Orders offered by the collation sorts; both compare precomputed keys
+typedef enum {
+    SORTLIB_COLLATION_LOCALE,        // strcoll order of LC_COLLATE (strxfrm keys)
+    SORTLIB_COLLATION_CASE_FOLD      // Byte order after tolower
+} sortlib_CollationMode;
+
+// Fixed set of worker threads; the calling thread acts as worker 0
+typedef struct sortlib_ThreadPool sortlib_ThreadPool;
+
+typedef enum {
+    SORTLIB_PAGES_DEFAULT,           // Regular 4 KB pages
+    SORTLIB_PAGES_TRANSPARENT_HUGE,  // mmap + madvise(MADV_HUGEPAGE)
+    SORTLIB_PAGES_EXPLICIT_HUGE      // mmap(MAP_HUGETLB) from the reserved pool
+} sortlib_PageMode;
+
+// Single element operations of the array engines. The values are stored in
+// step trace files and must not change.
+typedef enum {
+    SORTLIB_OP_COMPARE = 1,          // first, second: indices compared
+    SORTLIB_OP_SWAP = 2,             // first, second: indices swapped
+    SORTLIB_OP_WRITE = 3             // first: index, second: value written
+} sortlib_Operation;
+
+typedef enum {
+    SORTLIB_STEP_START,              // algorithm, ascending; first: heap arity, second: threads (0 if n/a)
+    SORTLIB_STEP_SWAP,               // first: pass (arrays only), second: swaps so far
+    SORTLIB_STEP_INSERT,             // Arrays: first: position, value: key; lists: first: inserts so far
+    SORTLIB_STEP_MERGE,              // first, second: merged range, inclusive
+    SORTLIB_STEP_PIVOT,              // A partition finished; data ends at its range
+    SORTLIB_STEP_GAP,                // Comb sort swap; first: gap
+    SORTLIB_STEP_HEAP_BUILT,
+    SORTLIB_STEP_EXTRACT,            // first: elements extracted so far
+    SORTLIB_STEP_SORTED,             // Pass without swaps, the rest is skipped
+    SORTLIB_STEP_SPLIT,              // String MSD split; first: byte offset, second: non-empty buckets
+    SORTLIB_STEP_RANGE,              // Counting sort histogram done; value: minimum, first: key range
+    SORTLIB_STEP_RUN,                // Counting sort wrote a value; value: key, first: occurrences
+    SORTLIB_STEP_KEYS                // Collation keys built; first: key block bytes
+} sortlib_StepKind;
+
+typedef enum {
+    SORTLIB_DATA_INTS,               // data: const int*, length elements
+    SORTLIB_DATA_STRINGS,            // data: char* const*, length rows
+    SORTLIB_DATA_LIST                // data: const sortlib_Node*, NULL-terminated
+} sortlib_DataKind;
+
+// One visualization step; fields not listed for the kind are zero
+typedef struct {
+    sortlib_StepKind kind;
+    sortlib_DataKind dataKind;
+    const void* data;                // Current state of the data being sorted
+    size_t length;
+    const char* algorithm;           // SORTLIB_STEP_START only
+    bool ascending;                  // SORTLIB_STEP_START only
+    size_t first;
+    size_t second;
+    long long value;
+} sortlib_Step;
+
+// Receives the steps of the engine call it is passed to; engines given NULL
+// report nothing. Either callback may be NULL; onOperation is only called by
+// the int array engines. Steps are reported on the calling thread.
+typedef struct {
+    void (*onStep)(void* context, const sortlib_Step* step);
+    void (*onOperation)(void* context, sortlib_Operation op, uint64_t first, uint64_t second);
+    void* context;
+} sortlib_Observer;
+
+typedef void (*sortlib_ArraySortFunction)(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                          const sortlib_Observer* observer);
+
+// Priority queue entry: key plus caller data (e.g. the run a key came from)
+typedef struct {
+    int key;
+    size_t payload;
+} sortlib_HeapEntry;
+
+// d-ary heap; data[0] is the root. The allocation is padded so every group of
+// siblings starts on a cache-line boundary (see sortlib_createPriorityQueue)
+typedef struct {
+    sortlib_HeapEntry* data;
+    sortlib_HeapEntry* allocation;
+    size_t size;
+    size_t capacity;
+    unsigned int arity;
+    bool minHeap;
+    sortlib_Stats stats;
+} sortlib_PriorityQueue;
+
+// Sorted base array plus a buffer of unsorted inserts merged in batches
+typedef struct {
+    int* base;
+    size_t size;
+    size_t capacity;
+    int* batch;
+    size_t batchSize;
+    size_t batchCapacity;
+    bool ascending;
+    sortlib_Stats stats;             // Accumulated over all flushes
+} sortlib_SortedContainer;
+
+// LSM-like variant: tier t holds one sorted run of at most
+// batchCapacity * SORTLIB_TIER_FANOUT^(t+1) elements
+typedef struct {
+    int* runs[SORTLIB_MAX_TIERS];
+    size_t runSizes[SORTLIB_MAX_TIERS];
+    int* batch;
+    size_t batchSize;
+    size_t batchCapacity;
+    bool ascending;
+    sortlib_Stats stats;
+} sortlib_TieredContainer;
+
+// ============================================================================
+// LARGE PAGE BUFFERS
+// ============================================================================
+
+const char* sortlib_pageModeName(sortlib_PageMode mode);
+void* sortlib_allocLargeBuffer(size_t bytes, sortlib_PageMode mode, sortlib_PageMode* used);
+void sortlib_freeLargeBuffer(void* ptr, size_t bytes);
+
+// ============================================================================
+// THREAD POOL
+// ============================================================================
+
+// NULL when out of memory or a worker thread cannot be started. The parallel
+// engines map scratch blocks of at least SORTLIB_LARGE_BUFFER_THRESHOLD bytes
+// with scratchPages (SORTLIB_PAGES_DEFAULT: malloc).
+sortlib_ThreadPool* sortlib_createThreadPool(unsigned int numThreads, sortlib_PageMode scratchPages);
+unsigned int sortlib_threadPoolSize(const sortlib_ThreadPool* pool);
+void sortlib_runThreadPool(sortlib_ThreadPool* pool, sortlib_PoolTask task, void* ctx);
+void sortlib_destroyThreadPool(sortlib_ThreadPool* pool);
+void sortlib_firstTouchBuffer(void* buffer, size_t bytes, sortlib_ThreadPool* pool);
+
+// ============================================================================
+// SORTING ALGORITHMS
+// ============================================================================
+
+void sortlib_bubbleSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                             const sortlib_Observer* observer);
+void sortlib_selectionSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                const sortlib_Observer* observer);
+void sortlib_insertionSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                const sortlib_Observer* observer);
+void sortlib_mergeSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                            const sortlib_Observer* observer);
+void sortlib_quickSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                            const sortlib_Observer* observer);
+void sortlib_combSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                           const sortlib_Observer* observer);
+void sortlib_heapSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                           const sortlib_Observer* observer);
+void sortlib_heapSortArrayWithArity(int* arr, size_t size, unsigned int arity, bool ascending, sortlib_Stats* stats,
+                                    const sortlib_Observer* observer);
+
+// Both count only while sortlib_countingSortWins, in at most
+// SORTLIB_COUNTING_RANGE_FACTOR size_t counters per element. Wider ranges go
+// to quick sort; Auto radix sorts them instead from SORTLIB_AUTO_RADIX_MIN_SIZE
+// elements on, unless given an observer.
+void sortlib_countingSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                               const sortlib_Observer* observer);
+void sortlib_autoSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                           const sortlib_Observer* observer);
+
+// Stable merge sort in at most bufferLength ints of scratch (0: rotations
+// only, no scratch at all); sortlib_blockMergeSortArray uses
+// sortlib_blockMergeBufferLength(size)
+size_t sortlib_blockMergeBufferLength(size_t size);
+void sortlib_blockMergeSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                 const sortlib_Observer* observer);
+void sortlib_blockMergeSortArrayWithBuffer(int* arr, size_t size, size_t bufferLength, bool ascending,
+                                           sortlib_Stats* stats, const sortlib_Observer* observer);
+
+// sortlib_<engine>Sort<Type> for Int32, Int64, UInt32, UInt64, Float and
+// Double; NaNs always sort last
+#define SORTLIB_DECLARE_TYPED_ARRAY_SORTS(TYPE, NAME)                                              \
+    void sortlib_insertionSort##NAME(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats); \
+    void sortlib_mergeSort##NAME(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats);     \
+    void sortlib_quickSort##NAME(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats);     \
+    void sortlib_heapSort##NAME(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats);      \
+    void sortlib_radixSort##NAME(TYPE* arr, size_t size, bool ascending, sortlib_Stats* stats);
+
+SORTLIB_DECLARE_TYPED_ARRAY_SORTS(int32_t, Int32)
+SORTLIB_DECLARE_TYPED_ARRAY_SORTS(int64_t, Int64)
+SORTLIB_DECLARE_TYPED_ARRAY_SORTS(uint32_t, UInt32)
+SORTLIB_DECLARE_TYPED_ARRAY_SORTS(uint64_t, UInt64)
+SORTLIB_DECLARE_TYPED_ARRAY_SORTS(float, Float)
+SORTLIB_DECLARE_TYPED_ARRAY_SORTS(double, Double)
+
+void sortlib_bubbleSortMatrix(char** matrix, unsigned int rows, bool ascending, sortlib_Stats* stats,
+                              const sortlib_Observer* observer);
+// The list sorts relink the nodes and are stable: equal strings keep their order
+void sortlib_bubbleSortList(sortlib_Node** head, bool ascending, sortlib_Stats* stats,
+                            const sortlib_Observer* observer);
+void sortlib_insertionSortList(sortlib_Node** head, bool ascending, sortlib_Stats* stats,
+                               const sortlib_Observer* observer);
+
+void sortlib_threeWayQuickSort(int* arr, size_t size, bool ascending, sortlib_Stats* stats);
+void sortlib_parallelRadixSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                    sortlib_ThreadPool* pool);
+void sortlib_parallelSampleSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                     sortlib_ThreadPool* pool);
+void sortlib_parallelCountingSortArray(int* arr, size_t size, bool ascending, sortlib_Stats* stats,
+                                       sortlib_ThreadPool* pool);
+
+// Counting sort support: the min/max pre-pass (size >= 1), the number of keys
+// in [minValue, maxValue], and whether counting beats quick sort for them
+void sortlib_intRange(const int* arr, size_t size, int* minValue, int* maxValue, sortlib_Stats* stats);
+size_t sortlib_intRangeLength(int minValue, int maxValue);
+bool sortlib_countingSortWins(size_t size, size_t range);
+
+// Distinct values of arr in sort order with their multiplicities; values and
+// counts need room for size entries. Returns the number of distinct values.
+size_t sortlib_countDistinctInts(const int* arr, size_t size, bool ascending, int* values, size_t* counts,
+                                 sortlib_Stats* stats);
+void sortlib_parallelStringSortMatrix(char** matrix, size_t rows, bool ascending, sortlib_Stats* stats,
+                                      sortlib_ThreadPool* pool, const sortlib_Observer* observer);
+
+// Writes the collation key of str like strxfrm: at most outSize bytes, NUL
+// included; returns the key length. strcmp on keys gives the mode's order.
+size_t sortlib_collationKey(const char* str, sortlib_CollationMode mode, char* out, size_t outSize);
+
+// Transform every string once into a collation key, sort the keys byte-wise
+// and reorder the rows / relink the nodes. pool may be NULL (multikey
+// quicksort on the calling thread). Strings with equal keys keep no
+// particular order. False, leaving the data untouched, when out of memory.
+bool sortlib_collationSortMatrix(char** matrix, size_t rows, sortlib_CollationMode mode, bool ascending,
+                                 sortlib_Stats* stats, sortlib_ThreadPool* pool, const sortlib_Observer* observer);
+bool sortlib_collationSortList(sortlib_Node** head, sortlib_CollationMode mode, bool ascending, sortlib_Stats* stats,
+                               const sortlib_Observer* observer);
+
+// Sorts the rows of table->data in place. Returns false, leaving the table
+// untouched, when a key column is not below table->cols, the table's size
+// in bytes overflows size_t or its scratch cannot be allocated.
+bool sortlib_sortTableRows(sortlib_IntMatrix* table, const sortlib_Key* keys, size_t numKeys, sortlib_Stats* stats);
+
+// Array i is data[offsets[i], offsets[i + 1]); pool may be NULL
+void sortlib_sortArrayBatch(int* data, const size_t* offsets, size_t count, bool ascending, bool interleave,
+                            sortlib_Stats* stats, sortlib_ThreadPool* pool);
+
+// ============================================================================
+// PRIORITY QUEUE (D-ARY HEAP)
+// ============================================================================
+
+// create returns NULL and push false (queue unchanged) when out of memory
+sortlib_PriorityQueue* sortlib_createPriorityQueue(unsigned int arity, bool minHeap, size_t initialCapacity);
+bool sortlib_pushPriorityQueue(sortlib_PriorityQueue* pq, int key, size_t payload);
+bool sortlib_peekPriorityQueue(const sortlib_PriorityQueue* pq, sortlib_HeapEntry* out);
+bool sortlib_popPriorityQueue(sortlib_PriorityQueue* pq, sortlib_HeapEntry* out);
+void sortlib_freePriorityQueue(sortlib_PriorityQueue* pq);
+
+// ============================================================================
+// INCREMENTAL SORTED CONTAINERS
+// ============================================================================
+
+// The bool functions return false when out of memory: init leaves a container
+// that only free accepts, insert drops the value, flush and materialize keep
+// the pending batch (out is not written)
+bool sortlib_initSortedContainer(sortlib_SortedContainer* c, size_t batchCapacity, bool ascending);
+bool sortlib_flushSortedContainer(sortlib_SortedContainer* c);
+bool sortlib_insertSortedContainer(sortlib_SortedContainer* c, int value);
+void sortlib_freeSortedContainer(sortlib_SortedContainer* c);
+bool sortlib_initTieredContainer(sortlib_TieredContainer* c, size_t batchCapacity, bool ascending);
+bool sortlib_flushTieredContainer(sortlib_TieredContainer* c);
+bool sortlib_insertTieredContainer(sortlib_TieredContainer* c, int value);
+size_t sortlib_tieredContainerSize(const sortlib_TieredContainer* c);
+bool sortlib_materializeTieredContainer(sortlib_TieredContainer* c, int* out);
+void sortlib_freeTieredContainer(sortlib_TieredContainer* c);
+
+// ============================================================================
+// LIBRARY ENTRY POINTS
+// ============================================================================
+
+// None of these allocate, print or report steps. scratch must be aligned
+// like malloc's result; stats may be NULL where noted.
+
+// Bytes of scratch that make sortlib_sortInts a stable merge sort
+size_t sortlib_sortScratchBytes(size_t size);
+
+// Counting sort when the key range is small (sortlib_countingSortWins) and
+// scratch holds a size_t per key, else merge sort in scratch when it holds
+// sortlib_sortScratchBytes(size) bytes, else block merge sort when it holds
+// sortlib_blockMergeBufferLength(size) ints, otherwise an in-place heap sort
+// (not stable). scratch may be NULL.
+void sortlib_sortInts(int* arr, size_t size, bool ascending, void* scratch, size_t scratchBytes);
+void sortlib_sortIntsWithStats(int* arr, size_t size, bool ascending, void* scratch, size_t scratchBytes,
+                               sortlib_Stats* stats);
+
+// Moves the k elements that sort first into arr[0, k), in order; the rest of
+// the array is left in unspecified order. In place; stats may be NULL.
+void sortlib_partialSortInts(int* arr, size_t size, size_t k, bool ascending, sortlib_Stats* stats);
+
+// Bytes of scratch sortlib_parallelSortInts needs for its radix passes
+size_t sortlib_parallelSortScratchBytes(size_t size);
+
+// Parallel LSD radix sort on pool's threads in the caller's scratch. Without
+// a pool or with less than sortlib_parallelSortScratchBytes(size) bytes it
+// falls back to sortlib_sortIntsWithStats on the calling thread. stats may be
+// NULL.
+void sortlib_parallelSortInts(int* arr, size_t size, bool ascending, void* scratch, size_t scratchBytes,
+                              sortlib_ThreadPool* pool, sortlib_Stats* stats);
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC visibility pop
+#endif
+
+#endif
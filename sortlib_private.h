@@ -0,0 +1,45 @@
+#ifndef SORTLIB_PRIVATE_H
+#define SORTLIB_PRIVATE_H
+
+// Benchmark hooks of libsortlib for the sorting_algorithms program: the menu's
+// algorithm tables, the scratch allocation counters and the engines' clock.
+// Not part of the library's API; libsortlib.so does not export any of it.
+
+#include "sortlib.h"
+
+#define NUM_ARRAY_ALGORITHMS 10
+#define NUM_RUNTIME_ORDER_ALGORITHMS 7
+
+typedef struct {
+    const char* name;
+    sortlib_ArraySortFunction sort;
+    size_t (*scratchBytes)(size_t size);  // Heap scratch upper bound for size elements, for memory budgets
+} ArrayAlgorithm;
+
+// Wall clock in milliseconds, as used for sortlib_Stats.execution_time_ms
+double sortlib_timeMs(void);
+
+// Bracket one measured sort: fill bytesAllocated, allocations and
+// peakHeapBytes of stats from the engines' scratch allocations in between
+void sortlib_beginScratchMeasurement(void);
+void sortlib_endScratchMeasurement(sortlib_Stats* stats);
+
+// The array engines in menu order, and the comparison engines with the
+// per-comparison order check (for the specialization benchmark)
+extern const ArrayAlgorithm sortlib_arrayAlgorithms[NUM_ARRAY_ALGORITHMS];
+extern const ArrayAlgorithm sortlib_runtimeOrderAlgorithms[NUM_RUNTIME_ORDER_ALGORITHMS];
+void sortlib_bubbleSortMatrixRuntimeOrder(char** matrix, unsigned int rows, bool ascending, sortlib_Stats* stats,
+                                          const sortlib_Observer* observer);
+
+// Stability probes: Merge Sort, Block Merge and the comparison sorts of
+// sortlib_sortIntsWithStats instantiated (ascending) for records packed into
+// an int. The key (-32768..32767) is in the upper 16 bits and is all the
+// kernels compare; the payload (0..65535) below it shows how ties were ordered.
+#define SORTLIB_RECORD(key, payload) ((key) * 65536 + (int)(payload))
+#define SORTLIB_RECORD_KEY(record) ((record) >> 16)
+#define SORTLIB_RECORD_PAYLOAD(record) ((record) & 0xFFFF)
+void sortlib_mergeSortRecords(int* records, size_t size, sortlib_Stats* stats);
+void sortlib_blockMergeSortRecords(int* records, size_t size, size_t bufferLength, sortlib_Stats* stats);
+void sortlib_scratchSortRecords(int* records, size_t size, void* scratch, size_t scratchBytes, sortlib_Stats* stats);
+
+#endif